@@ -0,0 +1,355 @@
+//
+// Created by Gianmarco Picarella on 17/10/22.
+//
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdint>
+#include <cstdio>
+#include <functional>
+#include <iostream>
+#include <limits>
+#include <set>
+#include <string>
+#include <vector>
+
+#include <TicTacToeQLearner.h>
+#include <StaticTicTacToeQLearner.h>
+#include <EpsilonOptimalOpponent.h>
+#include <RandomOpponent.h>
+#include <SolvedGameTable.h>
+#include <MNKQLearner.h>
+#include <MNKOpponents.h>
+
+#include <PlayerEnum.h>
+#include <BoardStatusEnum.h>
+#include <GameUtils.h>
+#include <EpisodeObservers.h>
+#include <PolicySerialization.h>
+#include <PolicyEvaluation.h>
+
+#include <CLI/CLI.hpp>
+
+namespace
+{
+    struct BenchmarkSettings
+    {
+        int myWarmupRepetitions { 2 };
+        int myRepetitions { 10 };
+        std::string myFilter;
+    };
+
+    struct BenchmarkResult
+    {
+        std::string myName;
+        uint64_t myOperationsCount;
+
+        // Nanoseconds per operation of every measured repetition
+        std::vector<double> myRepetitionTimes;
+    };
+
+    // Results of the benchmarked code are folded here, so that the compiler cannot drop it
+    volatile uint64_t benchmarkSink = 0;
+
+    // Times a job performing anOperationsCount operations, after some untimed warm-up runs
+    BenchmarkResult RunBenchmark(const std::string& aName, uint64_t anOperationsCount,
+                                 const BenchmarkSettings& someSettings, const std::function<void()>& aJob)
+    {
+        BenchmarkResult result { aName, anOperationsCount, {} };
+
+        for (auto repetitionIdx = 0; repetitionIdx < someSettings.myWarmupRepetitions; ++repetitionIdx)
+        {
+            aJob();
+        }
+
+        for (auto repetitionIdx = 0; repetitionIdx < someSettings.myRepetitions; ++repetitionIdx)
+        {
+            const auto startTime = std::chrono::steady_clock::now();
+            aJob();
+            const auto elapsedTime = std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - startTime);
+
+            result.myRepetitionTimes.push_back(elapsedTime.count() / anOperationsCount);
+        }
+
+        std::cerr << aName << ": " << *std::min_element(result.myRepetitionTimes.begin(), result.myRepetitionTimes.end()) << " ns/op (min)" << std::endl;
+
+        return result;
+    }
+
+    void PrintResults(const std::vector<BenchmarkResult>& someResults, const BenchmarkSettings& someSettings, std::FILE* anOutput)
+    {
+        std::fprintf(anOutput, "{\n  \"warmup_repetitions\": %d,\n  \"repetitions\": %d,\n", someSettings.myWarmupRepetitions, someSettings.myRepetitions);
+#ifdef DEBUG_FLAG
+        std::fprintf(anOutput, "  \"debug\": true,\n");
+#else
+        std::fprintf(anOutput, "  \"debug\": false,\n");
+#endif
+        std::fprintf(anOutput, "  \"benchmarks\": [");
+
+        for (std::size_t resultIdx = 0; resultIdx < someResults.size(); ++resultIdx)
+        {
+            auto times = someResults[resultIdx].myRepetitionTimes;
+            std::sort(times.begin(), times.end());
+
+            auto mean = 0.0;
+            for (const auto time : times) { mean += time; }
+            mean /= times.size();
+
+            auto variance = 0.0;
+            for (const auto time : times) { variance += (time - mean) * (time - mean); }
+            variance /= times.size();
+
+            const auto median = times.size() % 2 == 1 ? times[times.size() / 2] : (times[times.size() / 2 - 1] + times[times.size() / 2]) / 2;
+
+            std::fprintf(anOutput,
+                         "%s\n    {\n      \"name\": \"%s\",\n      \"operations\": %llu,\n"
+                         "      \"ns_per_op\": { \"min\": %.3f, \"median\": %.3f, \"mean\": %.3f, \"stddev\": %.3f, \"max\": %.3f },\n"
+                         "      \"ops_per_second\": %.1f\n    }",
+                         resultIdx == 0 ? "" : ",",
+                         someResults[resultIdx].myName.c_str(),
+                         static_cast<unsigned long long>(someResults[resultIdx].myOperationsCount),
+                         times.front(), median, mean, std::sqrt(variance), times.back(),
+                         1e9 / median);
+        }
+
+        std::fprintf(anOutput, "\n  ]\n}\n");
+    }
+
+    TTT::TicTacToeSettings<TTT::BoardStatus> GetBenchmarkSettings()
+    {
+        TTT::TicTacToeSettings<TTT::BoardStatus> agentSettings;
+
+        // Same defaults as tictactoe-rl
+        agentSettings.myGamma = 0.9f;
+        agentSettings.myRandomEpsilon = 0.3f;
+        agentSettings.myRandomEpsilonDecay = 0.000001f;
+        agentSettings.myLearningRate = 0.5f;
+        agentSettings.myIsTraining = true;
+
+        agentSettings.myStaticScores.insert(std::make_pair(TTT::BoardStatus::Win, 1.f));
+        agentSettings.myStaticScores.insert(std::make_pair(TTT::BoardStatus::Draw, 0.f));
+        agentSettings.myStaticScores.insert(std::make_pair(TTT::BoardStatus::Lose, -1.f));
+        agentSettings.myStaticScores.insert(std::make_pair(TTT::BoardStatus::Intermediate, 0.5f));
+
+        return agentSettings;
+    }
+}
+
+int main(int argc, char **argv)
+{
+    CLI::App cli { "Tic-tac-toe RL benchmarks" };
+
+    BenchmarkSettings benchmarkSettings;
+    std::string outputPath;
+    std::string policyPath { "tictactoe-rl-bench-policy" };
+
+    cli.add_option("--warmup", benchmarkSettings.myWarmupRepetitions, "Untimed repetitions before measuring")->check(CLI::Range(0, 1000));
+    cli.add_option("--repetitions", benchmarkSettings.myRepetitions, "Timed repetitions of every benchmark")->check(CLI::Range(1, 1000));
+    cli.add_option("--filter", benchmarkSettings.myFilter, "Only run the benchmarks whose name contains the filter");
+    cli.add_option("--output", outputPath, "JSON results path (Default prints on stdout)");
+    cli.add_option("--policy-path", policyPath, "Path prefix of the policy files written by the serialization benchmarks");
+
+    CLI11_PARSE(cli, argc, argv);
+
+    std::vector<BenchmarkResult> results;
+
+    const auto isBenchmarkSelected = [&](const std::string& aName) {
+        return aName.find(benchmarkSettings.myFilter) != std::string::npos;
+    };
+
+    const auto runBenchmark = [&](const std::string& aName, uint64_t anOperationsCount, const std::function<void()>& aJob) {
+        if (isBenchmarkSelected(aName))
+        {
+            results.push_back(RunBenchmark(aName, anOperationsCount, benchmarkSettings, aJob));
+        }
+    };
+
+    constexpr auto agentSide = TTT::Player::Cross;
+    constexpr auto opponentSide = TTT::Player::Nought;
+
+    // Boards reached by the agent moves and boards where the agent has to move
+    std::set<uint32_t> agentBoardsSet, opponentBoardsSet;
+
+    TTT::Utils::GenerateBoards(agentSide, agentSide, agentBoardsSet);
+    TTT::Utils::GenerateBoards(opponentSide, agentSide, opponentBoardsSet);
+
+    const std::vector<uint32_t> boards(agentBoardsSet.begin(), agentBoardsSet.end());
+    std::vector<uint32_t> agentTurnBoards { 0x00000000 };
+
+    for (const auto board : opponentBoardsSet)
+    {
+        if (TTT::Utils::GetBoardStatus(agentSide, board) == TTT::BoardStatus::Intermediate)
+        {
+            agentTurnBoards.push_back(board);
+        }
+    }
+
+    // Micro benchmarks
+
+    runBenchmark("GetBoardStatus", boards.size(), [&]() {
+        uint64_t statusesSum = 0;
+        for (const auto board : boards) { statusesSum += static_cast<uint64_t>(TTT::Utils::GetBoardStatus(agentSide, board)); }
+        benchmarkSink += statusesSum;
+    });
+
+    runBenchmark("GenerateMoves", agentTurnBoards.size(), [&]() {
+        uint64_t movesCount = 0;
+        for (const auto board : agentTurnBoards) { movesCount += TTT::Utils::GenerateMoves(agentSide, board).size(); }
+        benchmarkSink += movesCount;
+    });
+
+    runBenchmark("GenerateBoards", 1, [&]() {
+        std::set<uint32_t> generatedBoards;
+        TTT::Utils::GenerateBoards(agentSide, agentSide, generatedBoards);
+        benchmarkSink += generatedBoards.size();
+    });
+
+    runBenchmark("TicTacToeMinimax", 1, [&]() {
+        TTT::EpsilonOptimalOpponent optimalOpponent { opponentSide, 0.f };
+        benchmarkSink += optimalOpponent.TicTacToeMinimax(0x00000000, agentSide, std::numeric_limits<int>::min(), std::numeric_limits<int>::max());
+    });
+
+    runBenchmark("SolvedGameTable::GetOptimalMoves", agentTurnBoards.size(), [&]() {
+        const auto& solvedGameTable = TTT::SolvedGameTable::GetInstance();
+        uint64_t movesCount = 0;
+        for (const auto board : agentTurnBoards) { movesCount += solvedGameTable.GetOptimalMoves(board, agentSide).size(); }
+        benchmarkSink += movesCount;
+    });
+
+    TTT::TicTacToeQLearner trainedAgent { agentSide, GetBenchmarkSettings() };
+    TTT::RandomOpponent randomOpponent { opponentSide };
+    TTT::EpsilonOptimalOpponent optimalOpponent { opponentSide, 0.1f };
+
+    // Trained values and recorded episodes shared by the learner benchmarks
+    std::vector<std::vector<uint32_t>> episodes;
+
+    TTT::Utils::Simulate(static_cast<TTT::TicTacToeQLearner::Base::Base&>(trainedAgent), randomOpponent, 10000, true,
+                         TTT::Utils::MakeCallbackEpisodeObserver([&](const std::vector<uint32_t>& aGameplayHistory, int) { episodes.push_back(aGameplayHistory); }));
+
+    auto greedyAgent = trainedAgent;
+    greedyAgent.SetTrainingMode(false);
+
+    runBenchmark("GreedyJob", agentTurnBoards.size(), [&]() {
+        uint64_t movesSum = 0;
+        for (const auto board : agentTurnBoards) { movesSum += greedyAgent.GetNextAction(board); }
+        benchmarkSink += movesSum;
+    });
+
+    auto updatedAgent = trainedAgent;
+
+    runBenchmark("QLearnerPolicy::Update", episodes.size(), [&]() {
+        for (const auto& episode : episodes) { updatedAgent.Update(episode); }
+    });
+
+    // Macro benchmarks
+
+    constexpr auto simulatedEpisodesCount = 10000;
+
+    // Training episodes per second, agents keep learning across repetitions
+    TTT::TicTacToeQLearner randomOpponentAgent { agentSide, GetBenchmarkSettings() };
+    TTT::TicTacToeQLearner optimalOpponentAgent { agentSide, GetBenchmarkSettings() };
+
+    runBenchmark("Simulate/RandomOpponent", simulatedEpisodesCount, [&]() {
+        TTT::Utils::Simulate(static_cast<TTT::TicTacToeQLearner::Base::Base&>(randomOpponentAgent), randomOpponent, simulatedEpisodesCount);
+    });
+
+    runBenchmark("Simulate/EpsilonOptimalOpponent", simulatedEpisodesCount, [&]() {
+        TTT::Utils::Simulate(static_cast<TTT::TicTacToeQLearner::Base::Base&>(optimalOpponentAgent), optimalOpponent, simulatedEpisodesCount);
+    });
+
+    // Both sides learn from every episode, no scripted opponent
+    auto selfPlayOpponentSettings = GetBenchmarkSettings();
+    selfPlayOpponentSettings.myIsAgentDelayed = !selfPlayOpponentSettings.myIsAgentDelayed;
+
+    TTT::TicTacToeQLearner selfPlayAgent { agentSide, GetBenchmarkSettings() };
+    TTT::TicTacToeQLearner selfPlayOpponent { opponentSide, selfPlayOpponentSettings };
+
+    runBenchmark("SelfPlaySimulate", simulatedEpisodesCount, [&]() {
+        TTT::Utils::SelfPlaySimulate(selfPlayAgent, selfPlayOpponent, simulatedEpisodesCount);
+    });
+
+    // Same learning as Simulate/RandomOpponent, without virtual calls
+    TTT::StaticTicTacToeQLearner staticRandomOpponentAgent { agentSide, GetBenchmarkSettings() };
+
+    runBenchmark("Simulate/RandomOpponent/Static", simulatedEpisodesCount, [&]() {
+        TTT::Utils::Simulate(staticRandomOpponentAgent, randomOpponent, simulatedEpisodesCount);
+    });
+
+    // Same training loop on the bitboard engine, on the 3x3 board and on connect four
+    TTT::MNKQLearner<TTT::MNKTicTacToe> mnkAgent { agentSide, GetBenchmarkSettings() };
+    TTT::MNKRandomOpponent<TTT::MNKTicTacToe> mnkRandomOpponent { opponentSide };
+
+    runBenchmark("Simulate/RandomOpponent/MNK3x3", simulatedEpisodesCount, [&]() {
+        TTT::Utils::Simulate<TTT::MNKTicTacToe>(mnkAgent, mnkRandomOpponent, simulatedEpisodesCount);
+    });
+
+    TTT::MNKQLearner<TTT::ConnectFour> connectFourAgent { agentSide, GetBenchmarkSettings() };
+    TTT::MNKRandomOpponent<TTT::ConnectFour> connectFourRandomOpponent { opponentSide };
+
+    runBenchmark("Simulate/RandomOpponent/ConnectFour", simulatedEpisodesCount, [&]() {
+        TTT::Utils::Simulate<TTT::ConnectFour>(connectFourAgent, connectFourRandomOpponent, simulatedEpisodesCount);
+    });
+
+    auto onlineAgentSettings = GetBenchmarkSettings();
+    onlineAgentSettings.myUseOnlineUpdates = true;
+
+    TTT::TicTacToeQLearner onlineRandomOpponentAgent { agentSide, onlineAgentSettings };
+
+    runBenchmark("Simulate/RandomOpponent/Online", simulatedEpisodesCount, [&]() {
+        TTT::Utils::Simulate(static_cast<TTT::TicTacToeQLearner::Base::Base&>(onlineRandomOpponentAgent), randomOpponent, simulatedEpisodesCount);
+    });
+
+    // Exact counterparts of testing the greedy agent with episodes
+    runBenchmark("EvaluatePolicy/RandomOpponent", 1, [&]() {
+        benchmarkSink += TTT::Utils::EvaluatePolicy(greedyAgent, 1.f).myEvaluatedStatesCount;
+    });
+
+    runBenchmark("EvaluatePolicy/EpsilonOptimalOpponent", 1, [&]() {
+        benchmarkSink += TTT::Utils::EvaluatePolicy(greedyAgent, 0.f).myEvaluatedStatesCount;
+    });
+
+    for (const auto policyFormat : { TTT::PolicyFormat::Json, TTT::PolicyFormat::Binary })
+    {
+        const auto formatName = policyFormat == TTT::PolicyFormat::Json ? std::string("Json") : std::string("Binary");
+        const auto formatPath = policyPath + (policyFormat == TTT::PolicyFormat::Json ? ".json" : TTT::Utils::PolicyBinaryExtension);
+
+        if (!isBenchmarkSelected("SavePolicy/" + formatName) && !isBenchmarkSelected("LoadPolicy/" + formatName))
+        {
+            continue;
+        }
+
+        // Loaded by LoadPolicy whether SavePolicy runs or not
+        if (!TTT::Utils::SavePolicy(trainedAgent, formatPath, policyFormat))
+        {
+            std::cerr << "Failed to write " << formatPath << std::endl;
+            return 1;
+        }
+
+        runBenchmark("SavePolicy/" + formatName, 1, [&]() {
+            TTT::Utils::SavePolicy(trainedAgent, formatPath, policyFormat);
+        });
+
+        runBenchmark("LoadPolicy/" + formatName, 1, [&]() {
+            TTT::TicTacToeQLearner loadedAgent;
+            benchmarkSink += TTT::Utils::LoadPolicy(formatPath, policyFormat, loadedAgent) && loadedAgent.GetAgentId() == agentSide;
+        });
+
+        std::remove(formatPath.c_str());
+    }
+
+    auto* output = outputPath.empty() ? stdout : std::fopen(outputPath.c_str(), "w");
+
+    if (output == nullptr)
+    {
+        std::cerr << "Failed to open the results file " << outputPath << std::endl;
+        return 1;
+    }
+
+    PrintResults(results, benchmarkSettings, output);
+
+    if (output != stdout)
+    {
+        std::fclose(output);
+    }
+}
@@ -13,21 +13,61 @@
 #include <PlayerEnum.h>
 #include <BoardStatusEnum.h>
 #include <GameUtils.h>
+#include <ParallelSimulation.h>
+#include <BatchedEnvironment.h>
+#include <PolicySerialization.h>
+#include <PolicyCheckpointer.h>
+#include <PolicyServer.h>
+#include <TrainingMetrics.h>
+#include <EpisodeObservers.h>
+#include <ProgressReporter.h>
+#include <MNKQLearner.h>
+#include <MNKOpponents.h>
+#include <ValueIteration.h>
+#include <PolicyEvaluation.h>
+#include <HyperparameterSweep.h>
+#include <ResultsStream.h>
 
 #include <CLI/CLI.hpp>
 
+#include <cstdio>
+#include <cstdlib>
+#include <filesystem>
+#include <limits>
 #include <sstream>
-#include <cereal/archives/json.hpp>
+#include <mutex>
+
+#include <unistd.h>
 
 #include <indicators/cursor_control.hpp>
 #include <indicators/block_progress_bar.hpp>
 
 #include <matplot/matplot.h>
 
-void PlotData(const std::unordered_map<TTT::BoardStatus, int>& someResultsCount, const std::vector<float>& someCumulativeRewards)
+// Plots the episodes' results and a bounded number of cumulative reward points read back from a results stream
+void PlotData(const std::string& aResultsStreamPath)
 {
     using namespace matplot;
 
+    std::vector<TTT::Utils::ResultsStreamRecord> streamPoints;
+
+    if(!TTT::Utils::LoadResultsStreamPoints(aResultsStreamPath, 2000, streamPoints) || streamPoints.empty())
+    {
+        std::cerr << "No results to plot in " << aResultsStreamPath << std::endl;
+        return;
+    }
+
+    std::vector<double> episodesCounts { 0.0 };
+    std::vector<double> cumulativeRewards { 0.0 };
+
+    for(const auto& streamPoint : streamPoints)
+    {
+        episodesCounts.push_back(static_cast<double>(streamPoint.myEpisodesCount));
+        cumulativeRewards.push_back(streamPoint.myCumulativeReward);
+    }
+
+    const auto& totals = streamPoints.back();
+
     tiledlayout(2, 1);
 
     gcf()->width(800);
@@ -37,9 +77,9 @@ void PlotData(const std::unordered_map<TTT::BoardStatus, int>& someResultsCount,
     auto top = nexttile();
 
     bar(top, std::vector {
-            someResultsCount.find(TTT::BoardStatus::Win)->second,
-            someResultsCount.find(TTT::BoardStatus::Draw)->second,
-            someResultsCount.find(TTT::BoardStatus::Lose)->second });
+            static_cast<double>(totals.myResultsCounts[static_cast<uint32_t>(TTT::BoardStatus::Win)]),
+            static_cast<double>(totals.myResultsCounts[static_cast<uint32_t>(TTT::BoardStatus::Draw)]),
+            static_cast<double>(totals.myResultsCounts[static_cast<uint32_t>(TTT::BoardStatus::Lose)]) });
 
     top->title("Episodes' results");
     top->x_axis().ticklabels({"Wins", "Draws", "Loses"});
@@ -47,7 +87,7 @@ void PlotData(const std::unordered_map<TTT::BoardStatus, int>& someResultsCount,
 
     auto bottom = nexttile();
 
-    auto crfPlot = plot(bottom, someCumulativeRewards);
+    auto crfPlot = plot(bottom, episodesCounts, cumulativeRewards);
 
     bottom->title("Cumulative Reward Function");
     bottom->x_axis().ticklabels({"N. Episodes"});
@@ -59,10 +99,51 @@ void PlotData(const std::unordered_map<TTT::BoardStatus, int>& someResultsCount,
     show();
 }
 
+// Trains a learner on an m,n,k-game board against a random, or tactical when anOpponentEpsilon is given, opponent.
+// Larger boards have no serialized format yet, so their values only live for the run.
+template <typename Game>
+void TrainGameAgent(const TTT::TicTacToeSettings<TTT::BoardStatus>& someAgentSettings, const TTT::Player anAgentSide,
+                    int anIterationsCount, const float* anOpponentEpsilon, const uint64_t* aRandomSeed,
+                    TTT::Utils::ProgressReporter& aProgressReporter, TTT::TrainingMetrics* someTrainingMetrics,
+                    int (&anOutResultsCounts)[4], std::size_t& anOutLearnedBoardsCount)
+{
+    const auto opponentSide = static_cast<TTT::Player>((~static_cast<uint32_t>(anAgentSide)) & 0x3);
+
+    TTT::MNKQLearner<Game> agent { anAgentSide, someAgentSettings };
+
+    auto episodeObserver = TTT::Utils::MakeCallbackEpisodeObserver([&](const std::vector<typename Game::Board>& aGameplayHistory, int) {
+        ++anOutResultsCounts[static_cast<uint32_t>(Game::GetBoardStatus(anAgentSide, aGameplayHistory.back()))];
+        aProgressReporter.AddCompletedEpisodes(1);
+    });
+
+    const auto trainAgainst = [&](auto& anOpponent) {
+        if(aRandomSeed != nullptr)
+        {
+            agent.SetRandomGenerator(RL::RandomGenerator { *aRandomSeed, 0 });
+            anOpponent.SetRandomGenerator(RL::RandomGenerator { *aRandomSeed, 1 });
+        }
+
+        TTT::Utils::Simulate<Game>(agent, anOpponent, anIterationsCount, !someAgentSettings.myIsAgentDelayed,
+                                   episodeObserver, someTrainingMetrics);
+    };
+
+    if(anOpponentEpsilon == nullptr)
+    {
+        TTT::MNKRandomOpponent<Game> opponent { opponentSide };
+        trainAgainst(opponent);
+    }
+    else
+    {
+        TTT::MNKTacticalOpponent<Game> opponent { opponentSide, *anOpponentEpsilon };
+        trainAgainst(opponent);
+    }
+
+    anOutLearnedBoardsCount = agent.GetActionValueScores().GetStoredValuesCount();
+}
+
 int main(int argc, char **argv)
 {
     using namespace indicators;
-    show_console_cursor(false);
 
     CLI::App cli;
 
@@ -104,21 +185,201 @@ int main(int argc, char **argv)
     auto agentSideOption = cli.add_flag("--nought", isAgentNought, "Agent side is nought");
     auto agentDelayOption = cli.add_flag("--delay", agentSettings.myIsAgentDelayed, "Delay first agent move");
 
-    cli.add_flag("--plot", shouldPlot, "Plot cumulative reward and episodes' results");
+    auto symmetriesOption = cli.add_flag("--symmetric", agentSettings.myUseSymmetries, "Share values between rotated/reflected boards");
+    auto shareSidesOption = cli.add_flag("--share-sides", agentSettings.myShareSidesTable, "Store boards from the cross point of view");
+
+    auto plotOption = cli.add_flag("--plot", shouldPlot, "Plot cumulative reward and episodes' results");
+
+    std::string resultsStreamPath;
+    auto resultsStreamOption = cli.add_option("--results-stream", resultsStreamPath, "Binary file receiving the cumulative reward and results counts as training goes (Default is a temporary file when plotting)");
+
+    auto resultsStreamInterval { 0 };
+    auto resultsStreamIntervalOption = cli.add_option("--stream-interval", resultsStreamInterval, "Episodes per results stream record (Default is about a thousand records per run)");
+
+    resultsStreamIntervalOption->check(CLI::Range(1, std::numeric_limits<int>::max()));
 
     agentSideOption->needs(trainingOption);
     agentDelayOption->needs(trainingOption);
+    symmetriesOption->needs(trainingOption);
+    shareSidesOption->needs(trainingOption);
 
     std::string agentPath;
-    auto agentPathOption = cli.add_option("--path", agentPath, "Agent save/load path");
+    cli.add_option("--path", agentPath, "Agent save/load path");
 
-    agentPathOption->required();
+    std::string gameName { "3x3" };
+    auto gameOption = cli.add_option("--game", gameName, "Board: 3x3, 4x4 (four in a row), 5x5 (four in a row) or connect4 (Default is 3x3)");
+
+    gameOption->check(CLI::IsMember({"3x3", "4x4", "5x5", "connect4"}));
+    gameOption->needs(trainingOption);
+
+    std::string policyFormatName;
+    auto policyFormatOption = cli.add_option("--format", policyFormatName, "Agent file format: json or binary (Default is binary for .bin paths, json otherwise)");
+
+    policyFormatOption->check(CLI::IsMember({"json", "binary"}));
 
     auto epsilonValue { 0.0f };
     auto epsilonOptimalParam = cli.add_option("--optimal", epsilonValue, "Select epsilon-optimal opponent (Default equals to random)");
 
     epsilonOptimalParam->check(CLI::Range(0.f,1.f));
 
+    TTT::Utils::ParallelSimulationSettings parallelSettings;
+
+    auto threadsOption = cli.add_option("--threads", parallelSettings.myThreadsCount, "Number of simulation threads");
+    auto mergeIntervalOption = cli.add_option("--merge-interval", parallelSettings.myMergeInterval, "Episodes per thread between two merges of the learned values (Default merges at the end)");
+
+    auto useHogwild { false };
+    auto hogwildOption = cli.add_flag("--hogwild", useHogwild, "Threads update one shared lock-free table instead of merging private copies");
+
+    threadsOption->check(CLI::Range(1, 1024));
+    mergeIntervalOption->needs(threadsOption);
+    hogwildOption->needs(threadsOption);
+    hogwildOption->needs(trainingOption);
+
+    auto batchSize { 0 };
+    auto batchSizeOption = cli.add_option("--batch", batchSize, "Play the episodes in lockstep batches of the given size");
+
+    batchSizeOption->check(CLI::Range(1, 1 << 20));
+    batchSizeOption->excludes(threadsOption);
+
+    auto onlineUpdatesOption = cli.add_flag("--online", agentSettings.myUseOnlineUpdates, "Update the values after every move instead of replaying each episode");
+
+    onlineUpdatesOption->needs(trainingOption);
+    onlineUpdatesOption->excludes(batchSizeOption);
+
+    auto replayCapacityOption = cli.add_option("--replay", agentSettings.myReplayCapacity, "Experience replay buffer capacity, in transitions");
+    auto replayBatchSizeOption = cli.add_option("--replay-batch", agentSettings.myReplayBatchSize, "Transitions replayed after every episode (Default 32)");
+    auto prioritizedReplayOption = cli.add_flag("--prioritized", agentSettings.myUsePrioritizedReplay, "Replay transitions proportionally to their last TD error");
+
+    replayCapacityOption->check(CLI::Range(1, 1 << 24));
+    replayCapacityOption->needs(trainingOption);
+    replayCapacityOption->excludes(onlineUpdatesOption);
+    replayBatchSizeOption->check(CLI::Range(1, 1 << 16));
+    replayBatchSizeOption->needs(replayCapacityOption);
+    prioritizedReplayOption->needs(replayCapacityOption);
+
+    uint64_t randomSeed { 0 };
+    auto randomSeedOption = cli.add_option("--seed", randomSeed, "Seed of the agents' random generators (Default is non-reproducible)");
+
+    std::string metricsPath;
+    auto metricsPathOption = cli.add_option("--metrics", metricsPath, "Training metrics dump path");
+
+    std::string metricsFormatName;
+    auto metricsFormatOption = cli.add_option("--metrics-format", metricsFormatName, "Training metrics format: json or prometheus (Default is prometheus for .prom paths, json lines otherwise)");
+
+    metricsFormatOption->check(CLI::IsMember({"json", "prometheus"}));
+    metricsFormatOption->needs(metricsPathOption);
+
+    auto metricsInterval { 1.0 };
+    auto metricsIntervalOption = cli.add_option("--metrics-interval", metricsInterval, "Seconds between two training metrics dumps");
+
+    metricsIntervalOption->check(CLI::Range(0.0, 86400.0));
+    metricsIntervalOption->needs(metricsPathOption);
+    metricsPathOption->excludes(threadsOption);
+
+    auto checkpointEpisodesInterval { 0 };
+    auto checkpointEpisodesOption = cli.add_option("--checkpoint-episodes", checkpointEpisodesInterval, "Episodes between two checkpoints of the agent to its path");
+
+    auto checkpointSecondsInterval { 0.0 };
+    auto checkpointSecondsOption = cli.add_option("--checkpoint-seconds", checkpointSecondsInterval, "Seconds between two checkpoints of the agent to its path");
+
+    checkpointEpisodesOption->check(CLI::Range(1, std::numeric_limits<int>::max()));
+    checkpointSecondsOption->check(CLI::Range(0.001, 86400.0 * 365));
+
+    auto shouldResume { false };
+    auto resumeOption = cli.add_flag("--resume", shouldResume, "Continue training the agent saved at its path, with its settings and decayed epsilon");
+
+    resumeOption->needs(trainingOption);
+
+    // The saved agent brings its own settings, but for the training-time ones which are not saved
+    for(auto* settingsOption : { rewardsOption, learningSettingsOption, agentSideOption, agentDelayOption, symmetriesOption,
+                                 shareSidesOption })
+    {
+        resumeOption->excludes(settingsOption);
+    }
+
+    auto useSelfPlay { false };
+    auto selfPlayOption = cli.add_flag("--self-play", useSelfPlay, "Train against a second learner playing the other side instead of a scripted opponent");
+
+    std::string selfPlayOpponentPath;
+    auto selfPlayOpponentPathOption = cli.add_option("--opponent-path", selfPlayOpponentPath, "Save path of the self-play learner of the other side");
+
+    selfPlayOption->needs(trainingOption);
+    selfPlayOpponentPathOption->needs(selfPlayOption);
+
+    // Both learners play the same sequential episodes
+    for(auto* scriptedOpponentOption : { epsilonOptimalParam, threadsOption, batchSizeOption, resumeOption })
+    {
+        selfPlayOption->excludes(scriptedOpponentOption);
+    }
+
+    // Threads train private copies of the table until they are merged
+    for(auto* checkpointOption : { checkpointEpisodesOption, checkpointSecondsOption })
+    {
+        checkpointOption->needs(trainingOption);
+        checkpointOption->excludes(threadsOption);
+    }
+
+    auto useExactSolution { false };
+    auto exactSolutionOption = cli.add_flag("--exact", useExactSolution, "Instead of playing episodes, train by value iteration over every board or test by walking every game the agent can play");
+
+    auto maxLoseProbability { 1.0 };
+    auto maxLoseProbabilityOption = cli.add_option("--max-lose-probability", maxLoseProbability, "Exit with an error if the exactly tested agent loses more often than this");
+
+    maxLoseProbabilityOption->check(CLI::Range(0.0, 1.0));
+    maxLoseProbabilityOption->needs(exactSolutionOption);
+    maxLoseProbabilityOption->excludes(trainingOption);
+
+    for(auto* samplingOnlyOption : { threadsOption, batchSizeOption, onlineUpdatesOption, replayCapacityOption, metricsPathOption, plotOption, resultsStreamOption,
+                                       checkpointEpisodesOption, checkpointSecondsOption, resumeOption, selfPlayOption })
+    {
+        exactSolutionOption->excludes(samplingOnlyOption);
+    }
+
+    // Larger boards are trained by a single static learner on hashed boards
+    for(auto* tictactoeOnlyOption : { symmetriesOption, shareSidesOption, threadsOption, batchSizeOption,
+                                          onlineUpdatesOption, replayCapacityOption, plotOption, resultsStreamOption, exactSolutionOption,
+                                          checkpointEpisodesOption, checkpointSecondsOption, resumeOption, selfPlayOption })
+    {
+        gameOption->excludes(tictactoeOnlyOption);
+    }
+
+    // Options of the main command, like --path and --format, are given after serve
+    auto serveCommand = cli.add_subcommand("serve", "Serve the moves of a trained agent on stdin/stdout or on a Unix domain socket");
+
+    TTT::PolicyServerSettings serverSettings;
+
+    serveCommand->add_option("--socket", serverSettings.mySocketPath, "Unix domain socket path (Default serves stdin/stdout)");
+    serveCommand->add_option("--max-sessions", serverSettings.myMaxSessions, "Maximum number of concurrent socket sessions")->check(CLI::Range(1, 1 << 16));
+    serveCommand->add_option("--report-interval", serverSettings.myReportInterval, "Seconds between two latency reports (Default reports when stopping)")->check(CLI::Range(0, 86400));
+    serveCommand->fallthrough();
+
+    auto sweepCommand = cli.add_subcommand("sweep", "Train and rank many learning settings in one process");
+
+    TTT::Utils::SweepSpace sweepSpace;
+    TTT::Utils::SweepSettings sweepSettings;
+
+    std::vector<std::string> sweepRewardsVectors;
+    std::string sweepOutputPath;
+    auto sweepRandomCount { 0 };
+    auto isSweepAgentNought { false };
+    auto sweepTrainingOpponentEpsilon { 0.f };
+    uint64_t sweepSeed { 0 };
+
+    sweepCommand->add_option("--gamma", sweepSpace.myGammas, "Gamma values");
+    sweepCommand->add_option("--epsilon", sweepSpace.myRandomEpsilons, "Epsilon values");
+    sweepCommand->add_option("--epsilon-decay", sweepSpace.myRandomEpsilonDecays, "Epsilon decay values");
+    sweepCommand->add_option("--learning-rate", sweepSpace.myLearningRates, "Learning rate values");
+    sweepCommand->add_option("--rewards", sweepRewardsVectors, "Reward vectors, each one as Win,Draw,Lose,Intermediate");
+    sweepCommand->add_option("--random", sweepRandomCount, "Draw this many random configurations within the values ranges instead of trying every combination")->check(CLI::Range(1, 1 << 20));
+    sweepCommand->add_option("-i", sweepSettings.myTrainingEpisodesCount, "Training episodes per configuration");
+    sweepCommand->add_option("--eval-episodes", sweepSettings.myEvaluationEpisodesCount, "Evaluation episodes against each of the random and optimal opponents");
+    sweepCommand->add_option("--threads", sweepSettings.myThreadsCount, "Number of configurations trained at once")->check(CLI::Range(1, 1024));
+    auto sweepOpponentOption = sweepCommand->add_option("--optimal", sweepTrainingOpponentEpsilon, "Train against the epsilon-optimal opponent (Default equals to random)")->check(CLI::Range(0.f, 1.f));
+    sweepCommand->add_flag("--nought", isSweepAgentNought, "Agent side is nought");
+    sweepCommand->add_flag("--delay", sweepSettings.myIsAgentDelayed, "Delay first agent move");
+    auto sweepSeedOption = sweepCommand->add_option("--seed", sweepSeed, "Seed of the agents' random generators (Default is non-reproducible)");
+    sweepCommand->add_option("--output", sweepOutputPath, "Ranked results path, CSV for .csv paths, JSON otherwise")->required();
+
     BlockProgressBar cliProgressBar {
             option::BarWidth{80},
             option::Start{"["},
@@ -128,32 +389,213 @@ int main(int argc, char **argv)
     };
 
     cli.callback([&]() {
-        const auto opponentSide = isAgentNought ? TTT::Player::Cross : TTT::Player::Nought;
-        const auto agentSide = isAgentNought ? TTT::Player::Nought : TTT::Player::Cross;
+        const auto isLargerGame = gameName != "3x3";
 
-        TTT::TicTacToeQLearner* agentPtr;
-        RL::Agent<TTT::Player, uint32_t, uint32_t>* opponentPtr;
+        if(*sweepCommand)
+        {
+            // Given reward vectors replace the default one
+            if(!sweepRewardsVectors.empty())
+            {
+                sweepSpace.myRewards.clear();
+            }
+
+            for(const auto& rewardsVector : sweepRewardsVectors)
+            {
+                TTT::Utils::RewardValues rewardValues;
+
+                if(std::sscanf(rewardsVector.c_str(), "%f,%f,%f,%f", &rewardValues[0], &rewardValues[1], &rewardValues[2], &rewardValues[3]) != 4)
+                {
+                    throw CLI::ValidationError("--rewards", "invalid reward vector " + rewardsVector + ", expected Win,Draw,Lose,Intermediate");
+                }
+
+                sweepSpace.myRewards.push_back(rewardValues);
+            }
+
+            sweepSettings.myAgentSide = isSweepAgentNought ? TTT::Player::Nought : TTT::Player::Cross;
+            sweepSettings.myTrainingOpponentEpsilon = sweepOpponentOption->empty() ? -1.f : sweepTrainingOpponentEpsilon;
+            sweepSettings.mySeed = sweepSeedOption->empty() ? RL::RandomGenerator{}() : sweepSeed;
+
+            std::vector<TTT::Utils::SweepConfiguration> configurations;
+
+            if(sweepRandomCount > 0)
+            {
+                // Seeded by the first draw of the seed, so that it does not replay any of the workers' streams
+                RL::RandomGenerator configurationsGenerator { RL::RandomGenerator { sweepSettings.mySeed }() };
+
+                configurations = TTT::Utils::MakeRandomConfigurations(sweepSpace, sweepRandomCount, configurationsGenerator);
+            }
+            else
+            {
+                configurations = TTT::Utils::MakeGridConfigurations(sweepSpace);
+            }
 
-        if(epsilonOptimalParam->empty())
+            std::cout << "Sweeping " << configurations.size() << " configurations, seed " << sweepSettings.mySeed << std::endl;
+
+            std::mutex reportMutex;
+            auto doneCount { 0 };
+
+            const auto sweepResults = TTT::Utils::RunSweep(configurations, sweepSettings, [&](const TTT::Utils::SweepResult& aResult) {
+                std::lock_guard<std::mutex> lock(reportMutex);
+                std::cout << "[" << ++doneCount << "/" << configurations.size() << "] configuration "
+                          << aResult.myConfigurationIndex << " score " << aResult.myScore << std::endl;
+            });
+
+            if(!TTT::Utils::SaveSweepResults(sweepResults, sweepOutputPath))
+            {
+                std::cerr << "Failed to write " << sweepOutputPath << std::endl;
+                throw CLI::RuntimeError(1);
+            }
+
+            return;
+        }
+
+        // Agents trained on larger boards are not saved
+        if(agentPath.empty() && (*serveCommand || !isLargerGame))
         {
-            opponentPtr = new TTT::RandomOpponent{opponentSide};
+            throw CLI::RequiredError("--path");
         }
-        else
+
+        if(!agentPath.empty() && !*serveCommand && isLargerGame)
+        {
+            throw CLI::ValidationError("--path", "agents trained on larger boards are not saved");
+        }
+
+        const auto policyFormat = policyFormatOption->empty() ? TTT::Utils::GetPolicyFormat(agentPath) :
+                                  policyFormatName == "binary" ? TTT::PolicyFormat::Binary : TTT::PolicyFormat::Json;
+
+        if(*serveCommand)
         {
-            opponentPtr = new TTT::EpsilonOptimalOpponent{opponentSide, epsilonValue};
+            TTT::PolicyServer policyServer(agentPath, policyFormat);
+
+            if(!policyServer.IsValid())
+            {
+                throw CLI::ValidationError("--path", "Failed to load the agent from " + agentPath);
+            }
+
+            if(!policyServer.Run(serverSettings))
+            {
+                std::cerr << "Failed to listen on " << serverSettings.mySocketPath << std::endl;
+                throw CLI::RuntimeError(1);
+            }
+
+            return;
         }
 
-        if(agentSettings.myIsTraining)
+        show_console_cursor(false);
+
+        const auto agentSide = isAgentNought ? TTT::Player::Nought : TTT::Player::Cross;
+
+        if(!rewards.empty())
+        {
+            agentSettings.myStaticScores[TTT::BoardStatus::Win] = rewards[0];
+            agentSettings.myStaticScores[TTT::BoardStatus::Draw] = rewards[1];
+            agentSettings.myStaticScores[TTT::BoardStatus::Lose] = rewards[2];
+            agentSettings.myStaticScores[TTT::BoardStatus::Intermediate] = rewards[3];
+        }
+
+        TTT::TrainingMetrics trainingMetrics(1000, metricsInterval);
+        auto* trainingMetricsPtr = metricsPath.empty() ? nullptr : &trainingMetrics;
+
+        if(trainingMetricsPtr != nullptr)
+        {
+            const auto isPrometheusPath = metricsPath.size() >= 5 && metricsPath.compare(metricsPath.size() - 5, 5, ".prom") == 0;
+            const auto isPrometheus = metricsFormatOption->empty() ? isPrometheusPath : metricsFormatName == "prometheus";
+
+            if(!trainingMetrics.SetDumpFile(metricsPath, isPrometheus ? TTT::MetricsFormat::Prometheus : TTT::MetricsFormat::JsonLines))
+            {
+                std::cerr << "Failed to open the metrics file " << metricsPath << std::endl;
+                trainingMetricsPtr = nullptr;
+            }
+        }
+
+        const auto reportFailedMetricsDumps = [&]() {
+            if(trainingMetricsPtr != nullptr && trainingMetrics.GetFailedDumpsCount() > 0)
+            {
+                std::cerr << trainingMetrics.GetFailedDumpsCount() << " metrics snapshots could not be written to " << metricsPath << std::endl;
+            }
+        };
+
+        // Progress is rendered by the reporter thread, the simulations only hand it episodes' summaries
+        TTT::Utils::ProgressReporter progressReporter { [&](int aCompletedEpisodesCount) {
+            cliProgressBar.set_progress(100*aCompletedEpisodesCount/static_cast<float>(iterationsCount));
+        } };
+
+        if(isLargerGame)
         {
             cliProgressBar.set_option(option::PostfixText{"Training agent"});
 
-            if(!rewards.empty())
+            const auto* opponentEpsilon = epsilonOptimalParam->empty() ? nullptr : &epsilonValue;
+            const auto* seed = randomSeedOption->empty() ? nullptr : &randomSeed;
+
+            // Indexed by BoardStatus
+            int resultsCounts[4] { 0, 0, 0, 0 };
+            std::size_t learnedBoardsCount { 0 };
+
+            if(gameName == "4x4")
+            {
+                TrainGameAgent<TTT::MNKGame4x4x4>(agentSettings, agentSide, iterationsCount, opponentEpsilon, seed,
+                                                  progressReporter, trainingMetricsPtr, resultsCounts, learnedBoardsCount);
+            }
+            else if(gameName == "5x5")
             {
-                agentSettings.myStaticScores[TTT::BoardStatus::Win] = rewards[0];
-                agentSettings.myStaticScores[TTT::BoardStatus::Draw] = rewards[1];
-                agentSettings.myStaticScores[TTT::BoardStatus::Lose] = rewards[2];
-                agentSettings.myStaticScores[TTT::BoardStatus::Intermediate] = rewards[3];
+                TrainGameAgent<TTT::MNKGame5x5x4>(agentSettings, agentSide, iterationsCount, opponentEpsilon, seed,
+                                                  progressReporter, trainingMetricsPtr, resultsCounts, learnedBoardsCount);
             }
+            else
+            {
+                TrainGameAgent<TTT::ConnectFour>(agentSettings, agentSide, iterationsCount, opponentEpsilon, seed,
+                                                 progressReporter, trainingMetricsPtr, resultsCounts, learnedBoardsCount);
+            }
+
+            progressReporter.Stop();
+
+            cliProgressBar.set_option(option::PostfixText {"Done ✔"});
+            cliProgressBar.mark_as_completed();
+
+            std::cout << "Wins: " << resultsCounts[static_cast<uint32_t>(TTT::BoardStatus::Win)]
+                      << ", Draws: " << resultsCounts[static_cast<uint32_t>(TTT::BoardStatus::Draw)]
+                      << ", Loses: " << resultsCounts[static_cast<uint32_t>(TTT::BoardStatus::Lose)]
+                      << ", Learned boards: " << learnedBoardsCount << std::endl;
+
+            reportFailedMetricsDumps();
+
+            return;
+        }
+
+        TTT::TicTacToeQLearner* agentPtr;
+        auto isEvaluationFailed { false };
+        RL::Agent<TTT::Player, uint32_t, uint32_t>* opponentPtr = nullptr;
+
+        const auto createOpponent = [&]() -> std::unique_ptr<RL::Agent<TTT::Player, uint32_t, uint32_t>> {
+            // Loaded agents keep the side they were trained on
+            const auto opponentSide = static_cast<TTT::Player>((~static_cast<uint32_t>(agentPtr->GetAgentId())) & 0x3);
+
+            if(epsilonOptimalParam->empty())
+            {
+                return std::unique_ptr<RL::Agent<TTT::Player, uint32_t, uint32_t>>(new TTT::RandomOpponent{opponentSide});
+            }
+
+            return std::unique_ptr<RL::Agent<TTT::Player, uint32_t, uint32_t>>(new TTT::EpsilonOptimalOpponent{opponentSide, epsilonValue});
+        };
+
+        if(shouldResume)
+        {
+            cliProgressBar.set_option(option::PostfixText{"Resuming agent training"});
+
+            agentPtr = new TTT::TicTacToeQLearner;
+
+            if(!TTT::Utils::LoadPolicy(agentPath, policyFormat, *agentPtr))
+            {
+                delete agentPtr;
+                throw CLI::ValidationError("--path", "Failed to load the agent from " + agentPath);
+            }
+
+            agentPtr->SetTrainingMode(true);
+            agentPtr->SetTrainingTimeSettings(agentSettings);
+        }
+        else if(agentSettings.myIsTraining)
+        {
+            cliProgressBar.set_option(option::PostfixText{"Training agent"});
 
             agentPtr = new TTT::TicTacToeQLearner { agentSide, agentSettings };
         }
@@ -161,80 +603,274 @@ int main(int argc, char **argv)
         {
             cliProgressBar.set_option(option::PostfixText{"Testing agent"});
 
-            std::ifstream deserializePath(agentPath);
-            assert(deserializePath.is_open() && "Failed to open the deserialization stream");
+            agentPtr = new TTT::TicTacToeQLearner;
 
+            if(!TTT::Utils::LoadPolicy(agentPath, policyFormat, *agentPtr))
             {
-                cereal::JSONInputArchive jsonArchive(deserializePath);
-                agentPtr = new TTT::TicTacToeQLearner{};
-                jsonArchive(*agentPtr);
+                delete agentPtr;
+                throw CLI::ValidationError("--path", "Failed to load the agent from " + agentPath);
             }
 
-            deserializePath.close();
-
             agentPtr->SetTrainingMode(false);
         }
 
-        std::unordered_map<TTT::BoardStatus, int> resultsCounter;
-        std::vector<float> cumulativeRewards;
+        // Self-play opponent: same settings on the other side, moving first when the agent is delayed.
+        // It replaces the scripted opponent.
+        std::unique_ptr<TTT::TicTacToeQLearner> selfPlayOpponentPtr;
+
+        if(useSelfPlay)
+        {
+            const auto opponentSide = static_cast<TTT::Player>((~static_cast<uint32_t>(agentPtr->GetAgentId())) & 0x3);
+
+            auto selfPlayOpponentSettings = agentSettings;
+            selfPlayOpponentSettings.myIsAgentDelayed = !agentSettings.myIsAgentDelayed;
+
+            selfPlayOpponentPtr.reset(new TTT::TicTacToeQLearner { opponentSide, selfPlayOpponentSettings });
+        }
+        else
+        {
+            opponentPtr = createOpponent().release();
+        }
+
+        if(!randomSeedOption->empty())
+        {
+            // Every agent draws from its own stream of the same seed
+            agentPtr->SetRandomGenerator(RL::RandomGenerator { randomSeed, 0 });
 
-        const auto episodeCallback = [&](const std::vector<uint32_t>& aGameplayHistory, int anEpisodeIndex){
-            if(shouldPlot)
+            if(opponentPtr != nullptr)
             {
-                const auto boardStatus = TTT::Utils::GetBoardStatus(agentPtr->GetAgentId(), aGameplayHistory.back());
-                const auto reward = agentPtr->GetLearningSettings().myStaticScores.find(boardStatus)->second;
+                opponentPtr->SetRandomGenerator(RL::RandomGenerator { randomSeed, 1 });
+            }
 
-                cumulativeRewards.emplace_back(cumulativeRewards.back() + reward);
-                ++resultsCounter[boardStatus];
+            if(selfPlayOpponentPtr)
+            {
+                selfPlayOpponentPtr->SetRandomGenerator(RL::RandomGenerator { randomSeed, 2 });
             }
-            cliProgressBar.set_progress(100*(anEpisodeIndex+1)/static_cast<float>(iterationsCount));
-        };
+        }
 
-        if(shouldPlot)
+        // Plots are read back from a results stream, a temporary one unless a path is given
+        const auto shouldStreamResults = shouldPlot || !resultsStreamOption->empty();
+
+        if(shouldStreamResults && resultsStreamOption->empty())
         {
-            cumulativeRewards.reserve(iterationsCount+1);
-            cumulativeRewards.emplace_back(0.f);
+            // Unique per run, concurrent runs never write to each other's stream
+            auto temporaryPath = (std::filesystem::temp_directory_path() / "tictactoe-rl-results-XXXXXX").string();
+            const auto temporaryDescriptor = mkstemp(temporaryPath.data());
 
-            resultsCounter.insert(std::make_pair(TTT::BoardStatus::Win, 0));
-            resultsCounter.insert(std::make_pair(TTT::BoardStatus::Draw, 0));
-            resultsCounter.insert(std::make_pair(TTT::BoardStatus::Lose, 0));
+            if(temporaryDescriptor >= 0)
+            {
+                close(temporaryDescriptor);
+                resultsStreamPath = temporaryPath;
+            }
+        }
+
+        float streamedRewards[4] { 0.f, 0.f, 0.f, 0.f };
+
+        for (const auto status : { TTT::BoardStatus::Win, TTT::BoardStatus::Draw, TTT::BoardStatus::Lose })
+        {
+            streamedRewards[static_cast<uint32_t>(status)] = agentPtr->GetLearningSettings().myStaticScores.find(status)->second;
+        }
+
+        TTT::Utils::ResultsStreamWriter resultsStreamWriter { shouldStreamResults ? resultsStreamPath : std::string{}, streamedRewards };
+
+        if(shouldStreamResults && !resultsStreamWriter.IsOpen())
+        {
+            std::cerr << "Failed to open the results stream " << resultsStreamPath << std::endl;
         }
 
-        TTT::Utils::Simulate(
-                static_cast<TTT::TicTacToeQLearner::Base::Base&>(*agentPtr),
-                *opponentPtr,
-                iterationsCount,
-                !agentPtr->GetLearningSettings().myIsAgentDelayed,
-                episodeCallback);
+        // Only built when an interval is given, its snapshot buffers are not allocated otherwise
+        std::unique_ptr<TTT::Utils::PolicyCheckpointer> policyCheckpointerPtr;
+
+        if(!checkpointEpisodesOption->empty() || !checkpointSecondsOption->empty())
+        {
+            policyCheckpointerPtr.reset(new TTT::Utils::PolicyCheckpointer { *agentPtr, agentPath, policyFormat, checkpointEpisodesInterval, checkpointSecondsInterval });
+        }
+
+        TTT::Utils::OptionalSummaryObserver<TTT::Utils::PolicyCheckpointer> policyCheckpointer { policyCheckpointerPtr.get() };
+
+        // About a thousand summaries per run by default, whatever the number of episodes
+        const auto summaryInterval = resultsStreamIntervalOption->empty() ? std::max(1, iterationsCount / 1000) : resultsStreamInterval;
+
+        if(useExactSolution && !agentSettings.myIsTraining)
+        {
+            const auto evaluationResult = TTT::Utils::EvaluatePolicy(*agentPtr, epsilonOptimalParam->empty() ? 1.f : epsilonValue);
+
+            progressReporter.AddCompletedEpisodes(iterationsCount);
+
+            const auto getOutcomeProbability = [&](const TTT::BoardStatus aStatus) {
+                return evaluationResult.myOutcomeProbabilities[static_cast<uint32_t>(aStatus)];
+            };
+
+            std::cout << "Exact outcome probabilities, Win: " << getOutcomeProbability(TTT::BoardStatus::Win)
+                      << ", Draw: " << getOutcomeProbability(TTT::BoardStatus::Draw)
+                      << ", Lose: " << getOutcomeProbability(TTT::BoardStatus::Lose)
+                      << " (" << evaluationResult.myEvaluatedStatesCount << " boards)" << std::endl;
+
+            isEvaluationFailed = getOutcomeProbability(TTT::BoardStatus::Lose) > maxLoseProbability;
+        }
+        else if(useExactSolution)
+        {
+            TTT::Utils::ValueIterationSettings valueIterationSettings;
+
+            // The random opponent is the epsilon-optimal one with epsilon 1
+            valueIterationSettings.myOpponentRandomEpsilon = epsilonOptimalParam->empty() ? 1.f : epsilonValue;
+
+            TTT::Utils::ValueIterationResult valueIterationResult;
+
+            *agentPtr = TTT::Utils::SolveActionValues(agentSide, agentSettings, valueIterationSettings, &valueIterationResult);
+
+            progressReporter.AddCompletedEpisodes(iterationsCount);
+
+            std::cout << "Value iteration sweeps: " << valueIterationResult.mySweepsCount
+                      << ", last max value change: " << valueIterationResult.myMaxValueChange << std::endl;
+        }
+        else if(parallelSettings.myThreadsCount > 1)
+        {
+            // Every worker folds its episodes into its own summaries, only handing them over takes a lock
+            TTT::Utils::SynchronizedSummaryObserver<TTT::Utils::ResultsStreamWriter, TTT::Utils::ProgressReporter> sharedSummaryObserver { resultsStreamWriter, progressReporter };
+
+            const auto workerSummaryInterval = std::max(1, summaryInterval / parallelSettings.myThreadsCount);
+            const auto agentId = agentPtr->GetAgentId();
+
+            const auto workerSummarizerFactory = [&](int) {
+                return TTT::Utils::MakeEpisodesSummarizer(agentId, workerSummaryInterval, sharedSummaryObserver);
+            };
+
+            if(useHogwild)
+            {
+                TTT::HogwildTicTacToeQLearner hogwildAgent { *agentPtr };
+
+                TTT::Utils::ParallelSimulate(
+                        hogwildAgent,
+                        createOpponent,
+                        iterationsCount,
+                        parallelSettings,
+                        !agentPtr->GetLearningSettings().myIsAgentDelayed,
+                        workerSummarizerFactory);
+
+                *agentPtr = TTT::TicTacToeQLearner { hogwildAgent };
+            }
+            else
+            {
+                TTT::Utils::ParallelSimulate(
+                        *agentPtr,
+                        createOpponent,
+                        iterationsCount,
+                        parallelSettings,
+                        !agentPtr->GetLearningSettings().myIsAgentDelayed,
+                        workerSummarizerFactory);
+            }
+        }
+        else if(selfPlayOpponentPtr)
+        {
+            TTT::Utils::SelfPlaySimulate(
+                    *agentPtr,
+                    *selfPlayOpponentPtr,
+                    iterationsCount,
+                    !agentPtr->GetLearningSettings().myIsAgentDelayed,
+                    TTT::Utils::MakeEpisodesSummarizer(agentPtr->GetAgentId(), summaryInterval, resultsStreamWriter, policyCheckpointer, progressReporter),
+                    trainingMetricsPtr);
+        }
+        else if(batchSize > 0)
+        {
+            auto episodesSummarizer = TTT::Utils::MakeEpisodesSummarizer(agentPtr->GetAgentId(), summaryInterval, resultsStreamWriter, policyCheckpointer, progressReporter);
+
+            const auto firstMoveFromLearner = !agentPtr->GetLearningSettings().myIsAgentDelayed;
+
+            // Uniform random moves are drawn by the environment itself
+            if(auto* randomOpponentPtr = dynamic_cast<TTT::RandomOpponent*>(opponentPtr))
+            {
+                TTT::Utils::BatchedSimulate(*agentPtr, *randomOpponentPtr, iterationsCount, batchSize, firstMoveFromLearner, episodesSummarizer, trainingMetricsPtr);
+            }
+            else
+            {
+                TTT::Utils::BatchedSimulate(*agentPtr, *opponentPtr, iterationsCount, batchSize, firstMoveFromLearner, episodesSummarizer, trainingMetricsPtr);
+            }
+        }
+        else
+        {
+            TTT::Utils::Simulate(
+                    static_cast<TTT::TicTacToeQLearner::Base::Base&>(*agentPtr),
+                    *opponentPtr,
+                    iterationsCount,
+                    !agentPtr->GetLearningSettings().myIsAgentDelayed,
+                    TTT::Utils::MakeEpisodesSummarizer(agentPtr->GetAgentId(), summaryInterval, resultsStreamWriter, policyCheckpointer, progressReporter),
+                    trainingMetricsPtr);
+        }
+
+        progressReporter.Stop();
 
         cliProgressBar.set_option(option::PostfixText {"Done ✔"});
         cliProgressBar.mark_as_completed();
 
+        if(shouldStreamResults && !resultsStreamWriter.Close())
+        {
+            std::cerr << "Failed to write the results stream " << resultsStreamPath << std::endl;
+        }
+
         if(shouldPlot)
         {
-            PlotData(resultsCounter, cumulativeRewards);
+            PlotData(resultsStreamPath);
+
+            if(resultsStreamOption->empty())
+            {
+                std::remove(resultsStreamPath.c_str());
+            }
         }
 
-        if(agentSettings.myIsTraining)
+        reportFailedMetricsDumps();
+
+        // A late checkpoint must not replace the final agent
+        if(policyCheckpointerPtr)
         {
-            std::ofstream serializeStream(agentPath);
-            assert(serializeStream.is_open() && "Failed to open the serialization stream");
+            policyCheckpointerPtr->Stop();
 
+            if(policyCheckpointerPtr->GetFailedCheckpointsCount() > 0)
             {
-                cereal::JSONOutputArchive archive(serializeStream);
-                archive(CEREAL_NVP(*agentPtr));
+                std::cerr << policyCheckpointerPtr->GetFailedCheckpointsCount() << " checkpoints could not be written to " << agentPath << std::endl;
             }
+        }
+
+        if(agentSettings.myIsTraining && !TTT::Utils::SavePolicyAtomically(*agentPtr, agentPath, policyFormat))
+        {
+            std::cerr << "Failed to save the agent to " << agentPath << std::endl;
+        }
 
-            serializeStream.close();
+        if(selfPlayOpponentPtr && !selfPlayOpponentPath.empty() &&
+           !TTT::Utils::SavePolicyAtomically(*selfPlayOpponentPtr, selfPlayOpponentPath, TTT::Utils::GetPolicyFormat(selfPlayOpponentPath)))
+        {
+            std::cerr << "Failed to save the self-play opponent to " << selfPlayOpponentPath << std::endl;
         }
 
-        assert(agentPtr != nullptr && opponentPtr != nullptr && "Agent or Opponent pointers cannot be nullptr");
+        assert(agentPtr != nullptr && (opponentPtr != nullptr || selfPlayOpponentPtr) && "Agent or Opponent pointers cannot be nullptr");
 
         delete agentPtr;
         delete opponentPtr;
 
+        if(isEvaluationFailed)
+        {
+            std::cerr << "Lose probability above " << maxLoseProbability << std::endl;
+            throw CLI::RuntimeError(1);
+        }
+
     });
 
-    CLI11_PARSE(cli, argc, argv);
-    indicators::show_console_cursor(true);
+    // Not CLI11_PARSE: the errors thrown by the commands would return before the cursor hidden by the progress bar is shown again
+    int exitCode = 0;
+
+    try
+    {
+        cli.parse(argc, argv);
+    }
+    catch(const CLI::ParseError& anError)
+    {
+        exitCode = cli.exit(anError);
+    }
+
+    if(!*serveCommand)
+    {
+        indicators::show_console_cursor(true);
+    }
+
+    return exitCode;
 }
\ No newline at end of file
@@ -0,0 +1,76 @@
+//
+// Created by Gianmarco Picarella on 10/10/22.
+//
+
+#ifndef RLEXPERIMENTS_HASHMAPACTIONVALUESTORAGE_H
+#define RLEXPERIMENTS_HASHMAPACTIONVALUESTORAGE_H
+
+#include <cereal/cereal.hpp>
+#include <cereal/types/unordered_map.hpp>
+#include <unordered_map>
+#include <vector>
+#include <cassert>
+
+namespace RL
+{
+    // Default action-value storage policy used by GreedyLearner.
+    // Any storage policy must expose Contains, Get, Set and Add with the same signatures.
+    template<typename Action>
+    class HashMapActionValueStorage
+    {
+    public:
+        // Copies own an independent table
+        static constexpr bool IsSharedBetweenCopies = false;
+
+        bool Contains(const Action& anAction) const
+        {
+            return myValues.find(anAction) != myValues.end();
+        }
+
+        float Get(const Action& anAction) const
+        {
+            assert(Contains(anAction));
+            return myValues.find(anAction)->second;
+        }
+
+        void Set(const Action& anAction, float aValue)
+        {
+            myValues[anAction] = aValue;
+        }
+
+        void Add(const Action& anAction, float aDelta)
+        {
+            assert(Contains(anAction));
+            myValues[anAction] += aDelta;
+        }
+
+        // Replaces every value with the mean of the same action across storages sharing this key set
+        void SetToAverageOf(const std::vector<const HashMapActionValueStorage*>& someStorages)
+        {
+            assert(!someStorages.empty());
+
+            for (auto& actionValue : myValues)
+            {
+                auto valuesSum = 0.f;
+
+                for (const auto* storage : someStorages)
+                {
+                    valuesSum += storage->Get(actionValue.first);
+                }
+
+                actionValue.second = valuesSum / someStorages.size();
+            }
+        }
+
+        template<class Archive>
+        void serialize(Archive & archive)
+        {
+            archive(CEREAL_NVP(myValues));
+        }
+
+    private:
+        std::unordered_map<Action, float> myValues;
+    };
+}
+
+#endif //RLEXPERIMENTS_HASHMAPACTIONVALUESTORAGE_H
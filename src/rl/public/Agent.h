@@ -8,6 +8,8 @@
 #include <cereal/cereal.hpp>
 #include <cereal/types/memory.hpp>
 
+#include "RandomGenerator.h"
+
 namespace RL
 {
 template <typename AgentId, typename Action, typename State>
@@ -21,6 +23,11 @@ public:
     const AgentId& GetAgentId() const { return myId; }
     virtual Action GetNextAction(const State& aCurrentState) = 0;
 
+    // Every random choice of the agent is drawn from its generator, copies of the agent copy its state
+    const RandomGenerator& GetRandomGenerator() const { return myRandomGenerator; }
+    RandomGenerator& GetRandomGenerator() { return myRandomGenerator; }
+    void SetRandomGenerator(const RandomGenerator& aRandomGenerator) { myRandomGenerator = aRandomGenerator; }
+
     template<class Archive>
     void serialize(Archive & archive)
     {
@@ -29,6 +36,9 @@ public:
 
 protected:
     AgentId myId;
+
+    // Not part of the serialized agent. Mutable since drawing does not change what the agent knows.
+    mutable RandomGenerator myRandomGenerator;
 };
 }
 
@@ -0,0 +1,48 @@
+//
+// Created by Gianmarco Picarella on 11/10/22.
+//
+
+#ifndef RLEXPERIMENTS_FIXEDCAPACITYLIST_H
+#define RLEXPERIMENTS_FIXEDCAPACITYLIST_H
+
+#include <cassert>
+#include <cstddef>
+
+namespace RL
+{
+    // Stack allocated list with a compile time capacity.
+    // It mirrors the subset of the std::vector interface used by learners and opponents.
+    template<typename T, std::size_t Capacity>
+    class FixedCapacityList
+    {
+    public:
+        using value_type = T;
+        using iterator = T*;
+        using const_iterator = const T*;
+
+        void push_back(const T& anItem)
+        {
+            assert(mySize < Capacity && "FixedCapacityList is full");
+            myItems[mySize++] = anItem;
+        }
+
+        void clear() { mySize = 0; }
+
+        std::size_t size() const { return mySize; }
+        bool empty() const { return mySize == 0; }
+
+        T& operator[](std::size_t anIndex) { assert(anIndex < mySize); return myItems[anIndex]; }
+        const T& operator[](std::size_t anIndex) const { assert(anIndex < mySize); return myItems[anIndex]; }
+
+        iterator begin() { return myItems; }
+        iterator end() { return myItems + mySize; }
+        const_iterator begin() const { return myItems; }
+        const_iterator end() const { return myItems + mySize; }
+
+    private:
+        T myItems[Capacity];
+        std::size_t mySize = 0;
+    };
+}
+
+#endif //RLEXPERIMENTS_FIXEDCAPACITYLIST_H
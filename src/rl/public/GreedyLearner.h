@@ -6,14 +6,13 @@
 #define RLEXPERIMENTS_GREEDYLEARNER_H
 
 #include "LearningPolicy.h"
+#include "ActionValueStorage/HashMapActionValueStorage.h"
 
-#include <cereal/types/unordered_map.hpp>
 #include <cereal/types/memory.hpp>
-#include <unordered_map>
-#include <random>
 
 namespace RL {
-    template<typename AgentId, typename State, typename Action, typename LearningSettings, typename ActionStatus>
+    template<typename AgentId, typename State, typename Action, typename LearningSettings, typename ActionStatus,
+            typename ActionValueStorage = HashMapActionValueStorage<Action>>
     class GreedyLearner : public LearningPolicy<AgentId, State, Action, LearningSettings, ActionStatus> {
     public:
         using Base = LearningPolicy<AgentId, State, Action, LearningSettings, ActionStatus>;
@@ -26,47 +25,75 @@ namespace RL {
         virtual ~GreedyLearner() {}
 
         Action GetNextAction(const State &aCurrentState) {
-            static std::random_device dev;
-            static std::mt19937 rng(dev());
+            float maxValue;
+            return SelectAction<false>(aCurrentState, maxValue);
+        }
+
+        const ActionValueStorage& GetActionValueScores() const { return myActionValueScores; }
+
+        void AverageActionValueScores(const std::vector<const ActionValueStorage*>& someActionValueScores)
+        {
+            myActionValueScores.SetToAverageOf(someActionValueScores);
+        }
+
+        void SetActionValueScores(const ActionValueStorage& someActionValueScores)
+        {
+            myActionValueScores = someActionValueScores;
+        }
 
+        void SetRandomEpsilon(float aRandomEpsilon)
+        {
+            Base::myLearningSettings.myRandomEpsilon = aRandomEpsilon;
+        }
+
+        template<class Archive>
+        void serialize(Archive & archive)
+        {
+            archive(cereal::base_class<Base>(this),
+                    CEREAL_NVP(myActionValueScores));
+        }
+
+    protected:
+        // Epsilon-greedy action selection. The greedy job reports the highest value among the actions available
+        // from aCurrentState, exploration moves only look it up when ComputeMaxValue is set.
+        template <bool ComputeMaxValue>
+        Action SelectAction(const State &aCurrentState, float& anOutMaxValue) {
             Action result;
 
             if (Base::myLearningSettings.myIsTraining)
             {
-                std::uniform_real_distribution<> uniFltDistribution(0.f, 1.f);
-
-                if (uniFltDistribution(rng) < Base::myLearningSettings.myRandomEpsilon)
+                if (Base::myRandomGenerator.NextFloat() < Base::myLearningSettings.myRandomEpsilon)
                 {
                     result = ExplorationJob(aCurrentState);
+                    ++Base::myStatistics.myExplorationActionsCount;
+
+                    if (ComputeMaxValue)
+                    {
+                        anOutMaxValue = GetMaxActionValue(aCurrentState);
+                    }
                 }
                 else
                 {
-                    result = GreedyJob(aCurrentState);
+                    result = GreedyJob(aCurrentState, anOutMaxValue);
+                    ++Base::myStatistics.myGreedyActionsCount;
                 }
 
                 Base::myLearningSettings.myRandomEpsilon *= (1.f - Base::myLearningSettings.myRandomEpsilonDecay);
             }
             else
             {
-                result = GreedyJob(aCurrentState);
+                result = GreedyJob(aCurrentState, anOutMaxValue);
+                ++Base::myStatistics.myGreedyActionsCount;
             }
 
             return result;
         }
 
-        template<class Archive>
-        void serialize(Archive & archive)
-        {
-            archive(cereal::base_class<Base>(this),
-                    CEREAL_NVP(myActionValueScores));
-        }
-
-    protected:
         virtual Action ExplorationJob(const State &aCurrentState) const = 0;
-        virtual Action GreedyJob(const State &aCurrentState) const = 0;
+        virtual Action GreedyJob(const State &aCurrentState, float& anOutMaxValue) const = 0;
+        virtual float GetMaxActionValue(const State &aCurrentState) const = 0;
 
-        using ActionValueScoresMap = std::unordered_map<Action, float>;
-        ActionValueScoresMap myActionValueScores;
+        ActionValueStorage myActionValueScores;
     };
 }
 #endif //RLEXPERIMENTS_GREEDYLEARNER_H
@@ -0,0 +1,26 @@
+//
+// Created by Gianmarco Picarella on 17/10/22.
+//
+
+#ifndef RLEXPERIMENTS_LEARNERSTATISTICS_H
+#define RLEXPERIMENTS_LEARNERSTATISTICS_H
+
+#include <cstdint>
+
+namespace RL
+{
+    // Counters updated by a learner while acting and learning.
+    // They are plain integers owned by every learner copy and are not serialized.
+    struct LearnerStatistics
+    {
+        uint64_t myExplorationActionsCount { 0 };
+        uint64_t myGreedyActionsCount { 0 };
+
+        uint64_t myValueUpdatesCount { 0 };
+
+        // Sum of the absolute changes applied to the action values
+        double myValueUpdatesMagnitudeSum { 0.0 };
+    };
+}
+
+#endif //RLEXPERIMENTS_LEARNERSTATISTICS_H
@@ -6,6 +6,7 @@
 #define RLEXPERIMENTS_LEARNINGPOLICY_H
 
 #include "Agent.h"
+#include "LearnerStatistics.h"
 #include "LearningSettings/LearningSettings.h"
 
 #include <cereal/types/base_class.hpp>
@@ -38,6 +39,14 @@ namespace RL {
 
         virtual void Update(const std::vector<uint32_t>& aGameplayHistory) = 0;
 
+        // Learners updating their values while playing are only told the final state of every episode,
+        // the simulations skip Update for them
+        virtual bool IsUpdatingOnline() const { return false; }
+        virtual void EndEpisode(const State& /*aFinalState*/) {}
+
+        const LearnerStatistics& GetStatistics() const { return myStatistics; }
+        void ResetStatistics() { myStatistics = LearnerStatistics{}; }
+
         template<class Archive>
         void serialize(Archive & archive)
         {
@@ -47,6 +56,7 @@ namespace RL {
 
     protected:
         LearningSettings myLearningSettings;
+        LearnerStatistics myStatistics;
     };
 }
 
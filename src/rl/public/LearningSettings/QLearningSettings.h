@@ -9,6 +9,8 @@
 
 #include <cereal/types/base_class.hpp>
 
+#include <cstddef>
+
 namespace RL
 {
     template<typename ActionStatus>
@@ -18,6 +20,16 @@ namespace RL
         float myRandomEpsilon = 0.0f;
         float myRandomEpsilonDecay = 0.0f;
 
+        // Back values up one transition at a time while playing, instead of replaying the episode history.
+        // A training-time choice, hence not serialized.
+        bool myUseOnlineUpdates = false;
+
+        // Transitions kept for experience replay (0 disables it) and transitions replayed after every episode.
+        // Training-time choices as well.
+        std::size_t myReplayCapacity = 0;
+        std::size_t myReplayBatchSize = 32;
+        bool myUsePrioritizedReplay = false;
+
         template<class Archive>
         void serialize(Archive & archive)
         {
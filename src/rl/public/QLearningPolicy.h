@@ -6,24 +6,105 @@
 #define RLEXPERIMENTS_QLEARNINGPOLICY_H
 
 #include "GreedyLearner.h"
+#include "ReplayBuffer.h"
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
 
 namespace RL
 {
-    template<typename AgentId, typename State, typename Action, typename LearningSettings, typename ActionStatus>
-    class QLearnerPolicy : public GreedyLearner<AgentId, State, Action, LearningSettings, ActionStatus> {
+    template<typename AgentId, typename State, typename Action, typename LearningSettings, typename ActionStatus,
+            typename ActionValueStorage = HashMapActionValueStorage<Action>, typename ActionList = std::vector<Action>>
+    class QLearnerPolicy : public GreedyLearner<AgentId, State, Action, LearningSettings, ActionStatus, ActionValueStorage> {
 
     public:
-        using Base = GreedyLearner<AgentId, State, Action, LearningSettings, ActionStatus>;
+        using Base = GreedyLearner<AgentId, State, Action, LearningSettings, ActionStatus, ActionValueStorage>;
 
         QLearnerPolicy() = delete;
 
+        using ReplayTransition = Transition<State, Action>;
+
         QLearnerPolicy(const AgentId &anAgentId, const LearningSettings &aLearningSettings) :
-            Base(anAgentId, aLearningSettings) {}
+            Base(anAgentId, aLearningSettings), myPendingAction(), myHasPendingAction(false),
+            myReplayBuffer(aLearningSettings.myReplayCapacity, aLearningSettings.myUsePrioritizedReplay)
+        {
+            myReplaySamples.reserve(aLearningSettings.myReplayBatchSize);
+        }
 
         virtual ~QLearnerPolicy() {}
 
+        // Online updates and experience replay are not serialized: learners resuming their training are given them again
+        void SetTrainingTimeSettings(const LearningSettings &aLearningSettings)
+        {
+            Base::myLearningSettings.myUseOnlineUpdates = aLearningSettings.myUseOnlineUpdates;
+            Base::myLearningSettings.myReplayCapacity = aLearningSettings.myReplayCapacity;
+            Base::myLearningSettings.myReplayBatchSize = aLearningSettings.myReplayBatchSize;
+            Base::myLearningSettings.myUsePrioritizedReplay = aLearningSettings.myUsePrioritizedReplay;
+
+            myHasPendingAction = false;
+            myReplayBuffer = ReplayBuffer<ReplayTransition>(aLearningSettings.myReplayCapacity, aLearningSettings.myUsePrioritizedReplay);
+            myReplaySamples.reserve(aLearningSettings.myReplayBatchSize);
+        }
+
+        // In online mode the previous action is backed up towards the highest value available from aCurrentState,
+        // which is the one the greedy selection reads anyway
+        Action GetNextAction(const State &aCurrentState)
+        {
+            if (!Base::myLearningSettings.myUseOnlineUpdates || !Base::myLearningSettings.myIsTraining)
+            {
+                return Base::GetNextAction(aCurrentState);
+            }
+
+            float maxValue;
+            const auto action = Base::template SelectAction<true>(aCurrentState, maxValue);
+
+            if (myHasPendingAction)
+            {
+                AddToActionValue(myPendingAction, Base::myLearningSettings.myLearningRate *
+                                                  (Base::myLearningSettings.myGamma * maxValue -
+                                                          Base::myActionValueScores.Get(myPendingAction)));
+            }
+
+            myPendingAction = action;
+            myHasPendingAction = true;
+
+            return action;
+        }
+
+        bool IsUpdatingOnline() const
+        {
+            return Base::myLearningSettings.myUseOnlineUpdates && Base::myLearningSettings.myIsTraining;
+        }
+
+        // Backs the last action up towards the reward, unless that action ended the episode:
+        // terminal states keep their static score, as in Update
+        void EndEpisode(const State &aFinalState)
+        {
+            if (!myHasPendingAction)
+            {
+                return;
+            }
+
+            ActionStatus lastMoveStatus;
+
+            if (!IsAgentLastMove(aFinalState, lastMoveStatus))
+            {
+                const auto reward = Base::myLearningSettings.myStaticScores[lastMoveStatus];
+
+                AddToActionValue(myPendingAction, Base::myLearningSettings.myLearningRate *
+                                                  (reward - Base::myActionValueScores.Get(myPendingAction)));
+            }
+
+            myHasPendingAction = false;
+        }
+
+        // Backs the episode up from its end. With experience replay, the episode's transitions are then stored
+        // and a batch of stored transitions is replayed.
         void Update(const std::vector <State> &aGameplayHistory)
     {
+        const auto isReplaying = myReplayBuffer.GetCapacity() > 0;
+
         ActionStatus lastMoveStatus;
         const auto isLastMoveFromAgent = IsAgentLastMove(aGameplayHistory.back(), lastMoveStatus);
 
@@ -32,8 +113,13 @@ namespace RL
 
             const auto reward = Base::myLearningSettings.myStaticScores[lastMoveStatus];
 
-            Base::myActionValueScores[agentMove] +=
-                    Base::myLearningSettings.myLearningRate * (reward - Base::myActionValueScores[agentMove]);
+            AddToActionValue(agentMove,
+                    Base::myLearningSettings.myLearningRate * (reward - Base::myActionValueScores.Get(agentMove)));
+
+            if (isReplaying)
+            {
+                myReplayBuffer.Add(ReplayTransition { agentMove, aGameplayHistory.back(), reward, true });
+            }
         }
 
         const auto startingMoveIndex = isLastMoveFromAgent ?
@@ -42,34 +128,82 @@ namespace RL
         for (int moveIndex = startingMoveIndex; moveIndex > -1; moveIndex -= 2) {
             const auto &nextState = aGameplayHistory[moveIndex + 1];
 
-            const auto& nextAgentMoves = ComputeAgentActions(nextState);
+            const auto nextAgentMoves = ComputeAgentActions(nextState);
 
             assert(nextAgentMoves.size() > 0);
 
-            const uint32_t maxValueMove = *std::max_element(nextAgentMoves.begin(), nextAgentMoves.end(),
-                                                            [&](auto &m1, auto &m2) {
-                                                                assert(Base::myActionValueScores.find(m1) !=
-                                                                               Base::myActionValueScores.end());
-                                                                assert(Base::myActionValueScores.find(m2) !=
-                                                                               Base::myActionValueScores.end());
+            auto maxValue = std::numeric_limits<float>::lowest();
 
-                                                                return Base::myActionValueScores.find(m1)->second <
-                                                                        Base::myActionValueScores.find(m2)->second;
-                                                            });
+            for (const auto& nextAgentMove : nextAgentMoves) {
+                maxValue = std::max(maxValue, Base::myActionValueScores.Get(nextAgentMove));
+            }
 
             const auto agentMove = aGameplayHistory[moveIndex];
 
-            assert(Base::myActionValueScores.find(agentMove) != Base::myActionValueScores.end());
+            assert(Base::myActionValueScores.Contains(agentMove));
+
+            AddToActionValue(agentMove, Base::myLearningSettings.myLearningRate *
+                                              (Base::myLearningSettings.myGamma * maxValue -
+                                                      Base::myActionValueScores.Get(agentMove)));
+
+            if (isReplaying)
+            {
+                myReplayBuffer.Add(ReplayTransition { agentMove, nextState, 0.f, false });
+            }
+        }
 
-            Base::myActionValueScores[agentMove] += Base::myLearningSettings.myLearningRate *
-                                              (Base::myLearningSettings.myGamma * Base::myActionValueScores[maxValueMove] -
-                                                      Base::myActionValueScores[agentMove]);
+        if (isReplaying)
+        {
+            ReplayTransitions(Base::myLearningSettings.myReplayBatchSize);
         }
     }
 
+        // Applies the Q-learning backup to aBatchSize transitions sampled from the replay buffer,
+        // scaled by their importance sampling weights for prioritized buffers
+        void ReplayTransitions(std::size_t aBatchSize)
+        {
+            if (myReplayBuffer.GetSize() == 0 || aBatchSize == 0)
+            {
+                return;
+            }
+
+            myReplayBuffer.Sample(Base::myRandomGenerator, aBatchSize, myReplaySamples);
+
+            for (const auto& replaySample : myReplaySamples)
+            {
+                const auto& transition = myReplayBuffer.Get(replaySample.myIndex);
+
+                const auto target = transition.myIsTerminal ? transition.myReward :
+                                    Base::myLearningSettings.myGamma * this->GetMaxActionValue(transition.myNextState);
+                const auto error = target - Base::myActionValueScores.Get(transition.myAction);
+
+                AddToActionValue(transition.myAction, Base::myLearningSettings.myLearningRate * replaySample.myWeight * error);
+                myReplayBuffer.UpdatePriority(replaySample.myIndex, error);
+            }
+        }
+
+        const ReplayBuffer<ReplayTransition>& GetReplayBuffer() const { return myReplayBuffer; }
+
     protected:
         virtual bool IsAgentLastMove(const State &aLastMove, ActionStatus& anOutMoveStatus) const = 0;
-        virtual std::vector<Action> ComputeAgentActions(const State& aCurrentState) const = 0;
+        virtual ActionList ComputeAgentActions(const State& aCurrentState) const = 0;
+
+    private:
+        // Last action of the current episode not backed up yet, online mode only
+        Action myPendingAction;
+        bool myHasPendingAction;
+
+        // Experience replay, not serialized
+        ReplayBuffer<ReplayTransition> myReplayBuffer;
+        std::vector<ReplaySample> myReplaySamples;
+
+        void AddToActionValue(const Action& anAction, float aDelta)
+        {
+            Base::myActionValueScores.Add(anAction, aDelta);
+
+            ++Base::myStatistics.myValueUpdatesCount;
+            Base::myStatistics.myValueUpdatesMagnitudeSum += std::fabs(aDelta);
+        }
 };
 }
 
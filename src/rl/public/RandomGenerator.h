@@ -0,0 +1,115 @@
+//
+// Created by Gianmarco Picarella on 16/10/22.
+//
+
+#ifndef RLEXPERIMENTS_RANDOMGENERATOR_H
+#define RLEXPERIMENTS_RANDOMGENERATOR_H
+
+#include <cstdint>
+#include <limits>
+#include <random>
+
+namespace RL
+{
+    // xoshiro256** generator, see https://prng.di.unimi.it.
+    // Seeds are expanded with SplitMix64. Streams are jumps of 2^128 draws from the seed, hence
+    // generators sharing a seed but not a stream never overlap.
+    // It satisfies UniformRandomBitGenerator, NextFloat and NextIndex cover what agents need without a distribution.
+    class RandomGenerator
+    {
+    public:
+        using result_type = uint64_t;
+
+        // Non reproducible seed
+        RandomGenerator() : RandomGenerator((static_cast<uint64_t>(std::random_device{}()) << 32) | std::random_device{}()) {}
+
+        explicit RandomGenerator(uint64_t aSeed, uint64_t aStream = 0)
+        {
+            for (auto& stateWord : myState)
+            {
+                aSeed += 0x9E3779B97F4A7C15ull;
+
+                auto mixedSeed = aSeed;
+                mixedSeed = (mixedSeed ^ (mixedSeed >> 30)) * 0xBF58476D1CE4E5B9ull;
+                mixedSeed = (mixedSeed ^ (mixedSeed >> 27)) * 0x94D049BB133111EBull;
+
+                stateWord = mixedSeed ^ (mixedSeed >> 31);
+            }
+
+            for (; aStream > 0; --aStream)
+            {
+                Jump();
+            }
+        }
+
+        static constexpr result_type min() { return 0; }
+        static constexpr result_type max() { return std::numeric_limits<result_type>::max(); }
+
+        result_type operator()()
+        {
+            const auto result = RotateLeft(myState[1] * 5, 7) * 9;
+            const auto shiftedState = myState[1] << 17;
+
+            myState[2] ^= myState[0];
+            myState[3] ^= myState[1];
+            myState[1] ^= myState[2];
+            myState[0] ^= myState[3];
+
+            myState[2] ^= shiftedState;
+            myState[3] = RotateLeft(myState[3], 45);
+
+            return result;
+        }
+
+        // Uniform in [0, 1)
+        float NextFloat()
+        {
+            return static_cast<float>((*this)() >> 40) * (1.f / 16777216.f);
+        }
+
+        // Uniform in [0, aCount), multiply-shift reduction (bias below aCount / 2^32)
+        uint32_t NextIndex(uint32_t aCount)
+        {
+            return static_cast<uint32_t>(((*this)() >> 32) * aCount >> 32);
+        }
+
+        // Advances the generator by 2^128 draws
+        void Jump()
+        {
+            constexpr uint64_t jumpPolynomial[] = { 0x180EC6D33CFD0ABAull, 0xD5A61266F0C9392Cull, 0xA9582618E03FC9AAull, 0x39ABDC4529B1661Cull };
+
+            uint64_t jumpedState[4] = { 0, 0, 0, 0 };
+
+            for (const auto polynomialWord : jumpPolynomial)
+            {
+                for (auto bit = 0; bit < 64; ++bit)
+                {
+                    if (polynomialWord & (1ull << bit))
+                    {
+                        for (auto wordIndex = 0; wordIndex < 4; ++wordIndex)
+                        {
+                            jumpedState[wordIndex] ^= myState[wordIndex];
+                        }
+                    }
+
+                    (*this)();
+                }
+            }
+
+            for (auto wordIndex = 0; wordIndex < 4; ++wordIndex)
+            {
+                myState[wordIndex] = jumpedState[wordIndex];
+            }
+        }
+
+    private:
+        static uint64_t RotateLeft(uint64_t aValue, int aShift)
+        {
+            return (aValue << aShift) | (aValue >> (64 - aShift));
+        }
+
+        uint64_t myState[4];
+    };
+}
+
+#endif //RLEXPERIMENTS_RANDOMGENERATOR_H
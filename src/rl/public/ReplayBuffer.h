@@ -0,0 +1,196 @@
+//
+// Created by Gianmarco Picarella on 17/10/22.
+//
+
+#ifndef RLEXPERIMENTS_REPLAYBUFFER_H
+#define RLEXPERIMENTS_REPLAYBUFFER_H
+
+#include <algorithm>
+#include <cassert>
+#include <cmath>
+#include <cstddef>
+#include <limits>
+#include <vector>
+
+#include "RandomGenerator.h"
+
+namespace RL
+{
+    // Action taken by a learner and what followed it: the next state the learner acts from, or the reward if the episode ended
+    template<typename State, typename Action>
+    struct Transition
+    {
+        Action myAction;
+        State myNextState;
+        float myReward;
+        bool myIsTerminal;
+    };
+
+    struct ReplaySample
+    {
+        std::size_t myIndex;
+
+        // Importance sampling weight, 1 for uniform sampling
+        float myWeight;
+    };
+
+    // Fixed-capacity ring buffer of transitions, the oldest transitions are overwritten once it is full.
+    // Transitions and sampling priorities are stored in arrays allocated up front, so adding and sampling never allocate.
+    // Prioritized buffers sample transitions proportionally to |TD error|^PriorityExponent through a sum tree,
+    // new transitions get the highest priority seen so far so that each one is replayed at least once.
+    template<typename Transition>
+    class ReplayBuffer
+    {
+    public:
+        explicit ReplayBuffer(std::size_t aCapacity = 0, bool anIsPrioritized = false,
+                              float aPriorityExponent = 0.6f, float anImportanceExponent = 0.4f) :
+                myTransitions(aCapacity),
+                myNextIndex(0),
+                mySize(0),
+                myIsPrioritized(anIsPrioritized),
+                myPriorityExponent(aPriorityExponent),
+                myImportanceExponent(anImportanceExponent),
+                myMaxPriority(1.f),
+                myLeavesCount(1)
+        {
+            if (myIsPrioritized)
+            {
+                while (myLeavesCount < aCapacity)
+                {
+                    myLeavesCount *= 2;
+                }
+
+                // Node 1 is the root, the leaves start at myLeavesCount
+                myPrioritiesTree.assign(2 * myLeavesCount, 0.f);
+                myMinPrioritiesTree.assign(2 * myLeavesCount, std::numeric_limits<float>::max());
+            }
+        }
+
+        std::size_t GetCapacity() const { return myTransitions.size(); }
+        std::size_t GetSize() const { return mySize; }
+        bool IsPrioritized() const { return myIsPrioritized; }
+
+        const Transition& Get(std::size_t anIndex) const { assert(anIndex < mySize); return myTransitions[anIndex]; }
+
+        void Add(const Transition& aTransition)
+        {
+            assert(!myTransitions.empty() && "Cannot add transitions to a replay buffer without capacity");
+
+            myTransitions[myNextIndex] = aTransition;
+
+            if (myIsPrioritized)
+            {
+                SetPriority(myNextIndex, myMaxPriority);
+            }
+
+            myNextIndex = myNextIndex + 1 == myTransitions.size() ? 0 : myNextIndex + 1;
+            mySize = std::min(mySize + 1, myTransitions.size());
+        }
+
+        // Replaces someOutSamples with aSamplesCount transitions drawn with replacement.
+        // Prioritized draws are stratified: one draw in each of aSamplesCount equal slices of the total priority.
+        void Sample(RandomGenerator& aRandomGenerator, std::size_t aSamplesCount, std::vector<ReplaySample>& someOutSamples) const
+        {
+            assert(mySize > 0 && "Cannot sample an empty replay buffer");
+
+            someOutSamples.resize(aSamplesCount);
+
+            if (!myIsPrioritized)
+            {
+                for (auto& sample : someOutSamples)
+                {
+                    sample = ReplaySample { aRandomGenerator.NextIndex(mySize), 1.f };
+                }
+
+                return;
+            }
+
+            const auto totalPriority = myPrioritiesTree[1];
+            const auto sliceSize = totalPriority / aSamplesCount;
+
+            // Weights are normalized by the largest one, which belongs to the least likely transition
+            const auto maxWeight = std::pow(mySize * myMinPrioritiesTree[1] / totalPriority, -myImportanceExponent);
+
+            for (std::size_t sampleIdx = 0; sampleIdx < aSamplesCount; ++sampleIdx)
+            {
+                const auto prefixSum = (sampleIdx + aRandomGenerator.NextFloat()) * sliceSize;
+                const auto index = FindPrefixSum(prefixSum);
+                const auto probability = myPrioritiesTree[myLeavesCount + index] / totalPriority;
+
+                someOutSamples[sampleIdx] = ReplaySample { index, std::pow(mySize * probability, -myImportanceExponent) / maxWeight };
+            }
+        }
+
+        // Sets the priority of a sampled transition from the TD error of its last replay
+        void UpdatePriority(std::size_t anIndex, float aTemporalDifferenceError)
+        {
+            if (!myIsPrioritized)
+            {
+                return;
+            }
+
+            constexpr auto minError = 0.0001f;
+
+            const auto priority = std::pow(std::fabs(aTemporalDifferenceError) + minError, myPriorityExponent);
+
+            myMaxPriority = std::max(myMaxPriority, priority);
+            SetPriority(anIndex, priority);
+        }
+
+    private:
+        void SetPriority(std::size_t anIndex, float aPriority)
+        {
+            auto node = myLeavesCount + anIndex;
+
+            myPrioritiesTree[node] = aPriority;
+            myMinPrioritiesTree[node] = aPriority;
+
+            // Parents are recomputed from their children, so that rounding errors do not pile up
+            for (node /= 2; node > 0; node /= 2)
+            {
+                myPrioritiesTree[node] = myPrioritiesTree[2 * node] + myPrioritiesTree[2 * node + 1];
+                myMinPrioritiesTree[node] = std::min(myMinPrioritiesTree[2 * node], myMinPrioritiesTree[2 * node + 1]);
+            }
+        }
+
+        // Leftmost transition whose priorities prefix sum reaches aPrefixSum
+        std::size_t FindPrefixSum(float aPrefixSum) const
+        {
+            std::size_t node = 1;
+
+            while (node < myLeavesCount)
+            {
+                const auto leftChild = 2 * node;
+
+                if (aPrefixSum < myPrioritiesTree[leftChild] || myPrioritiesTree[leftChild + 1] <= 0.f)
+                {
+                    node = leftChild;
+                }
+                else
+                {
+                    aPrefixSum -= myPrioritiesTree[leftChild];
+                    node = leftChild + 1;
+                }
+            }
+
+            // Rounding can land on an empty leaf past the stored transitions
+            return std::min(node - myLeavesCount, mySize - 1);
+        }
+
+        std::vector<Transition> myTransitions;
+        std::size_t myNextIndex;
+        std::size_t mySize;
+
+        bool myIsPrioritized;
+        float myPriorityExponent;
+        float myImportanceExponent;
+        float myMaxPriority;
+
+        // Sum and min trees over the transitions priorities, each node holds the sum (min) of its two children
+        std::size_t myLeavesCount;
+        std::vector<float> myPrioritiesTree;
+        std::vector<float> myMinPrioritiesTree;
+    };
+}
+
+#endif //RLEXPERIMENTS_REPLAYBUFFER_H
@@ -0,0 +1,50 @@
+//
+// Created by Gianmarco Picarella on 17/10/22.
+//
+
+#ifndef RLEXPERIMENTS_SERIALIZATIONUTILS_H
+#define RLEXPERIMENTS_SERIALIZATIONUTILS_H
+
+#include <cstring>
+
+#include <cereal/cereal.hpp>
+
+namespace RL
+{
+namespace Detail
+{
+    // Archives reading named nodes (JSON, XML) tell the name of the next one
+    template<class Archive>
+    auto IsNextNode(const Archive& anArchive, const char* aName, int) -> decltype(anArchive.getNodeName(), bool())
+    {
+        const char* nodeName = anArchive.getNodeName();
+        return nodeName != nullptr && std::strcmp(nodeName, aName) == 0;
+    }
+
+    template<class Archive>
+    bool IsNextNode(const Archive&, const char*, long)
+    {
+        return true;
+    }
+}
+
+    // Whether the next node read from anArchive is named aName, always true when saving or when nodes are not named.
+    // Lets loaders accept the layouts of the files saved before a member was added or renamed.
+    template<class Archive>
+    bool IsNextNode(const Archive& anArchive, const char* aName)
+    {
+        return Detail::IsNextNode(anArchive, aName, 0);
+    }
+
+    // Serializes a member missing from older files, which keeps its value when loading them
+    template<class Archive, typename T>
+    void SerializeOptionalNVP(Archive& anArchive, const char* aName, T& aValue)
+    {
+        if (IsNextNode(anArchive, aName))
+        {
+            anArchive(cereal::make_nvp(aName, aValue));
+        }
+    }
+}
+
+#endif //RLEXPERIMENTS_SERIALIZATIONUTILS_H
@@ -0,0 +1,42 @@
+//
+// Created by Gianmarco Picarella on 17/10/22.
+//
+
+#ifndef RLEXPERIMENTS_STATICAGENT_H
+#define RLEXPERIMENTS_STATICAGENT_H
+
+#include "RandomGenerator.h"
+
+namespace RL
+{
+// Compile-time counterpart of Agent for the simulation inner loop.
+// Derived classes implement a non-virtual
+//   Action GetNextAction(const State& aCurrentState)
+// and are passed by their concrete type to the templated simulations, so that the whole move selection can be inlined.
+template <typename Derived, typename AgentId, typename State, typename Action>
+class StaticAgent
+{
+public:
+    StaticAgent() = delete;
+    StaticAgent(const AgentId& anAgentId) : myId(anAgentId) {}
+
+    const AgentId& GetAgentId() const { return myId; }
+
+    const RandomGenerator& GetRandomGenerator() const { return myRandomGenerator; }
+    RandomGenerator& GetRandomGenerator() { return myRandomGenerator; }
+    void SetRandomGenerator(const RandomGenerator& aRandomGenerator) { myRandomGenerator = aRandomGenerator; }
+
+protected:
+    // Not virtual, static agents are never destroyed through a base pointer
+    ~StaticAgent() = default;
+
+    Derived& AsDerived() { return static_cast<Derived&>(*this); }
+    const Derived& AsDerived() const { return static_cast<const Derived&>(*this); }
+
+    AgentId myId;
+
+    mutable RandomGenerator myRandomGenerator;
+};
+}
+
+#endif //RLEXPERIMENTS_STATICAGENT_H
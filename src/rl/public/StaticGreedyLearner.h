@@ -0,0 +1,76 @@
+//
+// Created by Gianmarco Picarella on 17/10/22.
+//
+
+#ifndef RLEXPERIMENTS_STATICGREEDYLEARNER_H
+#define RLEXPERIMENTS_STATICGREEDYLEARNER_H
+
+#include "StaticLearningPolicy.h"
+
+#include <vector>
+
+namespace RL {
+    // Compile-time counterpart of GreedyLearner, derived classes implement
+    //   Action ExplorationJob(const State& aCurrentState) const
+    //   Action GreedyJob(const State& aCurrentState, float& anOutMaxValue) const
+    //   float GetMaxActionValue(const State& aCurrentState) const
+    template<typename Derived, typename AgentId, typename State, typename Action, typename LearningSettings, typename ActionStatus,
+            typename ActionValueStorage>
+    class StaticGreedyLearner : public StaticLearningPolicy<Derived, AgentId, State, Action, LearningSettings, ActionStatus> {
+    public:
+        using Base = StaticLearningPolicy<Derived, AgentId, State, Action, LearningSettings, ActionStatus>;
+
+        StaticGreedyLearner() = delete;
+
+        StaticGreedyLearner(const AgentId &anAgentId, const LearningSettings &aLearningSettings) :
+                Base(anAgentId, aLearningSettings) {}
+
+        Action GetNextAction(const State &aCurrentState) {
+            Action result;
+            float maxValue;
+
+            if (Base::myLearningSettings.myIsTraining &&
+                Base::myRandomGenerator.NextFloat() < Base::myLearningSettings.myRandomEpsilon)
+            {
+                result = Base::AsDerived().ExplorationJob(aCurrentState);
+                ++Base::myStatistics.myExplorationActionsCount;
+            }
+            else
+            {
+                result = Base::AsDerived().GreedyJob(aCurrentState, maxValue);
+                ++Base::myStatistics.myGreedyActionsCount;
+            }
+
+            if (Base::myLearningSettings.myIsTraining)
+            {
+                Base::myLearningSettings.myRandomEpsilon *= (1.f - Base::myLearningSettings.myRandomEpsilonDecay);
+            }
+
+            return result;
+        }
+
+        const ActionValueStorage& GetActionValueScores() const { return myActionValueScores; }
+
+        void AverageActionValueScores(const std::vector<const ActionValueStorage*>& someActionValueScores)
+        {
+            myActionValueScores.SetToAverageOf(someActionValueScores);
+        }
+
+        void SetActionValueScores(const ActionValueStorage& someActionValueScores)
+        {
+            myActionValueScores = someActionValueScores;
+        }
+
+        void SetRandomEpsilon(float aRandomEpsilon)
+        {
+            Base::myLearningSettings.myRandomEpsilon = aRandomEpsilon;
+        }
+
+    protected:
+        ~StaticGreedyLearner() = default;
+
+        ActionValueStorage myActionValueScores;
+    };
+}
+
+#endif //RLEXPERIMENTS_STATICGREEDYLEARNER_H
@@ -0,0 +1,54 @@
+//
+// Created by Gianmarco Picarella on 17/10/22.
+//
+
+#ifndef RLEXPERIMENTS_STATICLEARNINGPOLICY_H
+#define RLEXPERIMENTS_STATICLEARNINGPOLICY_H
+
+#include "StaticAgent.h"
+#include "LearnerStatistics.h"
+#include "LearningSettings/LearningSettings.h"
+
+#include <type_traits>
+
+namespace RL
+{
+    // Compile-time counterpart of LearningPolicy, derived classes implement a non-virtual
+    //   void Update(const std::vector<State>& aGameplayHistory)
+    template<typename Derived, typename AgentId, typename State, typename Action, typename LearningSettings, typename ActionStatus>
+    class StaticLearningPolicy : public StaticAgent<Derived, AgentId, State, Action> {
+    public:
+        using Base = StaticAgent<Derived, AgentId, State, Action>;
+
+        StaticLearningPolicy() = delete;
+
+        StaticLearningPolicy(const AgentId &anAgentId, const LearningSettings &aLearningSettings) : Base(anAgentId),
+                                                                                                    myLearningSettings(aLearningSettings)
+        {
+            static_assert(std::is_base_of<BaseLearningSettings<ActionStatus>, LearningSettings>::value,
+                          "[StaticLearningPolicy]: LearningSettings type is not a child type of BaseLearningSettings");
+        }
+
+        const LearningSettings &GetLearningSettings() const { return myLearningSettings; }
+
+        void SetTrainingMode(bool aTrainingFlag)
+        {
+            myLearningSettings.myIsTraining = aTrainingFlag;
+        }
+
+        // Static learners always learn from whole episodes
+        constexpr bool IsUpdatingOnline() const { return false; }
+        void EndEpisode(const State&) {}
+
+        const LearnerStatistics& GetStatistics() const { return myStatistics; }
+        void ResetStatistics() { myStatistics = LearnerStatistics{}; }
+
+    protected:
+        ~StaticLearningPolicy() = default;
+
+        LearningSettings myLearningSettings;
+        LearnerStatistics myStatistics;
+    };
+}
+
+#endif //RLEXPERIMENTS_STATICLEARNINGPOLICY_H
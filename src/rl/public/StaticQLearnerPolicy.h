@@ -0,0 +1,93 @@
+//
+// Created by Gianmarco Picarella on 17/10/22.
+//
+
+#ifndef RLEXPERIMENTS_STATICQLEARNERPOLICY_H
+#define RLEXPERIMENTS_STATICQLEARNERPOLICY_H
+
+#include "StaticGreedyLearner.h"
+
+#include <algorithm>
+#include <cassert>
+#include <cmath>
+#include <limits>
+#include <vector>
+
+namespace RL
+{
+    // Compile-time counterpart of QLearnerPolicy, derived classes implement
+    //   bool IsAgentLastMove(const State& aLastMove, ActionStatus& anOutMoveStatus) const
+    //   ActionList ComputeAgentActions(const State& aCurrentState) const
+    // on top of the StaticGreedyLearner jobs. Episodes are backed up from their end as in QLearnerPolicy::Update;
+    // online updates and experience replay are only offered by the virtual learner.
+    template<typename Derived, typename AgentId, typename State, typename Action, typename LearningSettings, typename ActionStatus,
+            typename ActionValueStorage, typename ActionList = std::vector<Action>>
+    class StaticQLearnerPolicy : public StaticGreedyLearner<Derived, AgentId, State, Action, LearningSettings, ActionStatus, ActionValueStorage> {
+
+    public:
+        using Base = StaticGreedyLearner<Derived, AgentId, State, Action, LearningSettings, ActionStatus, ActionValueStorage>;
+
+        StaticQLearnerPolicy() = delete;
+
+        StaticQLearnerPolicy(const AgentId &anAgentId, const LearningSettings &aLearningSettings) :
+            Base(anAgentId, aLearningSettings)
+        {
+            assert(!aLearningSettings.myUseOnlineUpdates && aLearningSettings.myReplayCapacity == 0 &&
+                   "Online updates and experience replay need the virtual QLearnerPolicy");
+        }
+
+        void Update(const std::vector <State> &aGameplayHistory)
+        {
+            ActionStatus lastMoveStatus;
+            const auto isLastMoveFromAgent = Base::AsDerived().IsAgentLastMove(aGameplayHistory.back(), lastMoveStatus);
+
+            if (!isLastMoveFromAgent) {
+                const auto &agentMove = aGameplayHistory[aGameplayHistory.size() - 2];
+
+                const auto reward = Base::myLearningSettings.myStaticScores[lastMoveStatus];
+
+                AddToActionValue(agentMove,
+                        Base::myLearningSettings.myLearningRate * (reward - Base::myActionValueScores.Get(agentMove)));
+            }
+
+            const auto startingMoveIndex = isLastMoveFromAgent ?
+                                           aGameplayHistory.size() - 3 : aGameplayHistory.size() - 4;
+
+            for (int moveIndex = startingMoveIndex; moveIndex > -1; moveIndex -= 2) {
+                const auto &nextState = aGameplayHistory[moveIndex + 1];
+
+                const auto nextAgentMoves = Base::AsDerived().ComputeAgentActions(nextState);
+
+                assert(nextAgentMoves.size() > 0);
+
+                auto maxValue = std::numeric_limits<float>::lowest();
+
+                for (const auto& nextAgentMove : nextAgentMoves) {
+                    maxValue = std::max(maxValue, Base::myActionValueScores.Get(nextAgentMove));
+                }
+
+                const auto agentMove = aGameplayHistory[moveIndex];
+
+                assert(Base::myActionValueScores.Contains(agentMove));
+
+                AddToActionValue(agentMove, Base::myLearningSettings.myLearningRate *
+                                                  (Base::myLearningSettings.myGamma * maxValue -
+                                                          Base::myActionValueScores.Get(agentMove)));
+            }
+        }
+
+    protected:
+        ~StaticQLearnerPolicy() = default;
+
+    private:
+        void AddToActionValue(const Action& anAction, float aDelta)
+        {
+            Base::myActionValueScores.Add(anAction, aDelta);
+
+            ++Base::myStatistics.myValueUpdatesCount;
+            Base::myStatistics.myValueUpdatesMagnitudeSum += std::fabs(aDelta);
+        }
+    };
+}
+
+#endif //RLEXPERIMENTS_STATICQLEARNERPOLICY_H
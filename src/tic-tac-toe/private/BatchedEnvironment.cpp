@@ -0,0 +1,116 @@
+//
+// Created by Gianmarco Picarella on 15/10/22.
+//
+
+#include "BatchedEnvironment.h"
+
+#ifdef __AVX2__
+#include <immintrin.h>
+#endif
+
+namespace TTT
+{
+    BatchedEnvironment::BatchedEnvironment(std::size_t aBatchSize) :
+            myBatchSize(aBatchSize),
+            myGamesCount(0),
+            myBoards(aBatchSize),
+            myStatuses(aBatchSize),
+            myHistories(aBatchSize * MaxEpisodeLength),
+            myEpisodeLengths(aBatchSize)
+    {
+        myEpisode.reserve(MaxEpisodeLength);
+    }
+
+    void BatchedEnvironment::Reset(std::size_t aGamesCount)
+    {
+        assert(aGamesCount <= myBatchSize && "Games count exceeds the batch size");
+
+        myGamesCount = aGamesCount;
+
+        std::fill(myBoards.begin(), myBoards.begin() + myGamesCount, 0x00000000);
+        std::fill(myStatuses.begin(), myStatuses.begin() + myGamesCount, static_cast<uint32_t>(BoardStatus::Intermediate));
+        std::fill(myEpisodeLengths.begin(), myEpisodeLengths.begin() + myGamesCount, 0);
+    }
+
+    void BatchedEnvironment::UpdateStatuses(const Player aLearnerPlayer)
+    {
+        std::size_t gameIndex = 0;
+
+#ifdef __AVX2__
+        const auto crossLineStatus = static_cast<uint32_t>(aLearnerPlayer == Player::Cross ? BoardStatus::Win : BoardStatus::Lose);
+        const auto noughtLineStatus = static_cast<uint32_t>(aLearnerPlayer == Player::Cross ? BoardStatus::Lose : BoardStatus::Win);
+
+        const auto allCells = _mm256_set1_epi32(static_cast<int>(Utils::Detail::AllCellsMask));
+        const auto drawStatuses = _mm256_set1_epi32(static_cast<int>(BoardStatus::Draw));
+        const auto crossLineStatuses = _mm256_set1_epi32(static_cast<int>(crossLineStatus));
+        const auto noughtLineStatuses = _mm256_set1_epi32(static_cast<int>(noughtLineStatus));
+
+        for (; gameIndex + 8 <= myGamesCount; gameIndex += 8)
+        {
+            const auto boards = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(myBoards.data() + gameIndex));
+
+            const auto crossCells = _mm256_and_si256(boards, allCells);
+            const auto noughtCells = _mm256_and_si256(_mm256_srli_epi32(boards, 1), allCells);
+
+            auto hasCrossLine = _mm256_setzero_si256();
+            auto hasNoughtLine = _mm256_setzero_si256();
+
+            for (const auto lineMask : Utils::Detail::WinningLinesMasks)
+            {
+                const auto lineMasks = _mm256_set1_epi32(static_cast<int>(lineMask));
+
+                hasCrossLine = _mm256_or_si256(hasCrossLine, _mm256_cmpeq_epi32(_mm256_and_si256(crossCells, lineMasks), lineMasks));
+                hasNoughtLine = _mm256_or_si256(hasNoughtLine, _mm256_cmpeq_epi32(_mm256_and_si256(noughtCells, lineMasks), lineMasks));
+            }
+
+            const auto isFull = _mm256_cmpeq_epi32(_mm256_or_si256(crossCells, noughtCells), allCells);
+
+            auto statuses = _mm256_and_si256(isFull, drawStatuses);
+            statuses = _mm256_blendv_epi8(statuses, crossLineStatuses, hasCrossLine);
+            statuses = _mm256_blendv_epi8(statuses, noughtLineStatuses, hasNoughtLine);
+
+            _mm256_storeu_si256(reinterpret_cast<__m256i*>(myStatuses.data() + gameIndex), statuses);
+        }
+
+#ifdef DEBUG_FLAG
+        for (std::size_t checkedGameIndex = 0; checkedGameIndex < gameIndex; ++checkedGameIndex)
+        {
+            assert(myStatuses[checkedGameIndex] == static_cast<uint32_t>(Utils::GetBoardStatus(aLearnerPlayer, myBoards[checkedGameIndex])) &&
+                   "Vectorized board status disagrees with GetBoardStatus");
+        }
+#endif
+#endif
+
+        for (; gameIndex < myGamesCount; ++gameIndex)
+        {
+            myStatuses[gameIndex] = static_cast<uint32_t>(Utils::GetBoardStatus(aLearnerPlayer, myBoards[gameIndex]));
+        }
+    }
+
+    void BatchedEnvironment::SelectMoves(RandomOpponent& aRandomOpponent, uint32_t aPly)
+    {
+        const auto playerId = static_cast<uint32_t>(aRandomOpponent.GetAgentId());
+        auto& randomGenerator = aRandomOpponent.GetRandomGenerator();
+
+        for (std::size_t gameIndex = 0; gameIndex < myGamesCount; ++gameIndex)
+        {
+            if (myStatuses[gameIndex] != static_cast<uint32_t>(BoardStatus::Intermediate))
+            {
+                continue;
+            }
+
+            auto emptyCells = Utils::GetEmptyCellsMask(myBoards[gameIndex]);
+
+            // Every ply fills one cell, a running game has 9 - aPly empty cells
+            assert(static_cast<uint32_t>(__builtin_popcount(emptyCells)) == MaxEpisodeLength - aPly);
+
+            for (auto skippedCells = randomGenerator.NextIndex(MaxEpisodeLength - aPly); skippedCells > 0; --skippedCells)
+            {
+                emptyCells &= emptyCells - 1;
+            }
+
+            myBoards[gameIndex] |= playerId << __builtin_ctz(emptyCells);
+            RecordMove(gameIndex, aPly);
+        }
+    }
+}
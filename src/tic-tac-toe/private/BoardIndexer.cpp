@@ -0,0 +1,146 @@
+//
+// Created by Gianmarco Picarella on 10/10/22.
+//
+
+#include "BoardIndexer.h"
+
+#include <algorithm>
+#include <cassert>
+
+namespace TTT
+{
+    namespace Utils
+    {
+        namespace
+        {
+            // Cell permutation of every symmetry: the cell at position i moves to position table[i].
+            // Cells are numbered by their 2-bit offset in the board divided by two.
+            struct CellPermutations
+            {
+                CellPermutations()
+                {
+                    for (uint32_t symmetryIndex = 0; symmetryIndex < BoardSymmetriesCount; ++symmetryIndex)
+                    {
+                        for (uint32_t cellIndex = 0; cellIndex < 9; ++cellIndex)
+                        {
+                            auto row = cellIndex / 3;
+                            auto column = cellIndex % 3;
+
+                            // Optional reflection followed by up to three 90 degrees rotations
+                            if (symmetryIndex & 0x4)
+                            {
+                                column = 2 - column;
+                            }
+
+                            for (uint32_t rotation = 0; rotation < (symmetryIndex & 0x3); ++rotation)
+                            {
+                                const auto rotatedRow = column;
+                                column = 2 - row;
+                                row = rotatedRow;
+                            }
+
+                            myTargetCells[symmetryIndex][cellIndex] = 3 * row + column;
+                        }
+                    }
+                }
+
+                uint32_t myTargetCells[BoardSymmetriesCount][9];
+            };
+        }
+
+        uint32_t TransformBoard(const uint32_t aBoard, const uint32_t aSymmetryIndex)
+        {
+            static const CellPermutations cellPermutations;
+
+            assert(aSymmetryIndex < BoardSymmetriesCount);
+
+            uint32_t transformedBoard = 0x00000000;
+
+            for (uint32_t cellIndex = 0; cellIndex < 9; ++cellIndex)
+            {
+                const auto cell = (aBoard >> (2 * cellIndex)) & 0x3;
+                transformedBoard |= cell << (2 * cellPermutations.myTargetCells[aSymmetryIndex][cellIndex]);
+            }
+
+            return transformedBoard;
+        }
+
+        const BoardSymmetries& BoardSymmetries::GetInstance()
+        {
+            static const BoardSymmetries boardSymmetries;
+            return boardSymmetries;
+        }
+
+        BoardSymmetries::BoardSymmetries() :
+                myCanonicalSlots(BoardRanksCount),
+                myColourSwappedRanks(BoardRanksCount),
+                myCanonicalColourSwappedSlots(BoardRanksCount)
+        {
+            // A canonical rank is the smallest of its class, its slot is always numbered before the other ranks map to it
+            for (uint32_t rank = 0; rank < BoardRanksCount; ++rank)
+            {
+                const auto board = GetBoardFromRank(rank);
+
+                auto canonicalRank = rank;
+
+                for (uint32_t symmetryIndex = 1; symmetryIndex < BoardSymmetriesCount; ++symmetryIndex)
+                {
+                    canonicalRank = std::min(canonicalRank, GetBoardRank(TransformBoard(board, symmetryIndex)));
+                }
+
+                if (canonicalRank == rank)
+                {
+                    myCanonicalSlots[rank] = static_cast<uint16_t>(myCanonicalSlotRanks.size());
+                    myCanonicalSlotRanks.push_back(static_cast<uint16_t>(rank));
+                }
+                else
+                {
+                    myCanonicalSlots[rank] = myCanonicalSlots[canonicalRank];
+                }
+
+                myColourSwappedRanks[rank] = static_cast<uint16_t>(GetBoardRank(SwapColours(board)));
+            }
+
+            for (uint32_t rank = 0; rank < BoardRanksCount; ++rank)
+            {
+                myCanonicalColourSwappedSlots[rank] = myCanonicalSlots[myColourSwappedRanks[rank]];
+            }
+        }
+
+        const uint16_t* BoardSymmetries::GetSlotsMapping(const bool aSymmetryReducedFlag, const bool aColourSwappedFlag) const
+        {
+            if (aSymmetryReducedFlag && aColourSwappedFlag)
+            {
+                return myCanonicalColourSwappedSlots.data();
+            }
+            else if (aSymmetryReducedFlag)
+            {
+                return myCanonicalSlots.data();
+            }
+            else if (aColourSwappedFlag)
+            {
+                return myColourSwappedRanks.data();
+            }
+
+            return nullptr;
+        }
+
+        uint32_t GetBoardFromRank(const uint32_t aRank)
+        {
+            assert(aRank < BoardRanksCount && "Board rank out of range");
+
+            uint32_t board = 0x00000000;
+            auto rank = aRank;
+
+            for (auto positionIndex = 0; positionIndex < 18; positionIndex += 2)
+            {
+                board |= (rank % 3) << positionIndex;
+                rank /= 3;
+            }
+
+            assert(GetBoardRank(board) == aRank);
+
+            return board;
+        }
+    }
+}
@@ -3,6 +3,9 @@
 //
 
 #include "GameUtils.h"
+#include "StateGraph.h"
+
+#include <algorithm>
 
 namespace TTT
 {
@@ -10,24 +13,94 @@ namespace TTT
     {
         namespace
         {
-            void RecursiveBoardsGeneration(const Player anAgentPlayer, const Player aPlayerToMove, const uint32_t aCurrentBoard, std::set<uint32_t>& someOutValidBoards)
+#ifdef DEBUG_FLAG
+            // Straightforward cell by cell evaluation, used to validate GetBoardStatus
+            BoardStatus GetBoardStatusReference(const Player aMovingPlayer, const uint32_t aBoard)
             {
-                for (const auto& modifiedBoard : GenerateMoves(aPlayerToMove, aCurrentBoard))
+                constexpr uint32_t checkOffsets[5] = { 18, 16, 8, 0, 0 };
+
+                const auto tl = ((aBoard >> 16) & 0x3);
+                const auto cl = ((aBoard >> 10) & 0x3);
+                const auto bl = ((aBoard >> 4) & 0x3);
+
+                const auto tc = ((aBoard >> 14) & 0x3);
+                const auto cc = ((aBoard >> 8) & 0x3);
+                const auto bc = ((aBoard >> 2) & 0x3);
+
+                const auto tr = ((aBoard >> 12) & 0x3);
+                const auto cr = ((aBoard >> 6) & 0x3);
+                const auto br = (aBoard & 0x3);
+
+                const auto movingPlayerId = static_cast<uint32_t>(aMovingPlayer);
+                const auto otherPlayerId = (~movingPlayerId) & 0x3;
+
+                const uint32_t verticalShiftIndex = (tl > 0 && tl == cl && cl == bl) |
+                                                    ((tc > 0 && tc == cc && cc == bc) << 1) |
+                                                    ((tr > 0 && tr == cr && cr == br) << 2);
+
+                assert((
+                               verticalShiftIndex == 0 ||
+                               verticalShiftIndex == 1 ||
+                               verticalShiftIndex == 2 ||
+                               verticalShiftIndex == 4) && "More than one vertical Tris found!");
+
+                const auto verticalCheck = ((aBoard >> checkOffsets[verticalShiftIndex]) & 0x3);
+
+                if (verticalCheck == movingPlayerId)
+                {
+                    return BoardStatus::Win;
+                }
+                else if (verticalCheck == otherPlayerId)
                 {
-                    const auto boardStatus = GetBoardStatus(anAgentPlayer, modifiedBoard);
+                    return BoardStatus::Lose;
+                }
 
-                    if (aPlayerToMove == anAgentPlayer)
-                    {
-                        someOutValidBoards.insert(modifiedBoard);
-                    }
+                const uint32_t horizontalShiftIndex = (tl > 0 && tl == tc && tc == tr) |
+                                                      ((cl > 0 && cl == cc && cc == cr) << 1) |
+                                                      ((bl > 0 && bl == bc && bc == br) << 2);
 
-                    if (boardStatus == BoardStatus::Intermediate)
-                    {
-                        const auto nextPlayerToMove = static_cast<Player>((~static_cast<uint32_t>(aPlayerToMove)) & 0x3);
-                        RecursiveBoardsGeneration(anAgentPlayer, nextPlayerToMove, modifiedBoard, someOutValidBoards);
-                    }
+                assert((
+                               horizontalShiftIndex == 0 ||
+                               horizontalShiftIndex == 1 ||
+                               horizontalShiftIndex == 2 ||
+                               horizontalShiftIndex == 4) && "More than one horizontal Tris found!");
+
+                const auto horizontalCheck = ((aBoard >> checkOffsets[horizontalShiftIndex]) & 0x3);
+
+                if (horizontalCheck == movingPlayerId)
+                {
+                    return BoardStatus::Win;
+                }
+                else if (horizontalCheck == otherPlayerId)
+                {
+                    return BoardStatus::Lose;
                 }
+
+                const uint32_t diagonalsShiftIndex = (tl > 0 && tl == cc && cc == br) |
+                                                     ((tr > 0 && tr == cc && cc == bl) << 1);
+
+                assert((
+                               diagonalsShiftIndex < 4));
+
+                const auto diagonalsCheck = ((aBoard >> checkOffsets[diagonalsShiftIndex]) & 0x3);
+
+                if (diagonalsCheck == movingPlayerId)
+                {
+                    return BoardStatus::Win;
+                }
+                else if (diagonalsCheck == otherPlayerId)
+                {
+                    return BoardStatus::Lose;
+                }
+
+                if (tl > 0 && cl > 0 && bl > 0 && tc > 0 && cc > 0 && bc > 0 && tr > 0 && cr > 0 && br > 0)
+                {
+                    return BoardStatus::Draw;
+                }
+
+                return BoardStatus::Intermediate;
             }
+#endif
         }
 
         std::string BoardToString(const uint32_t aBoard)
@@ -61,138 +134,49 @@ namespace TTT
             return board;
         }
 
-        BoardStatus GetBoardStatus(const Player aMovingPlayer, const uint32_t aBoard)
-        {
-            constexpr uint32_t checkOffsets[5] = { 18, 16, 8, 0, 0 };
-
-            const auto tl = ((aBoard >> 16) & 0x3);
-            const auto cl = ((aBoard >> 10) & 0x3);
-            const auto bl = ((aBoard >> 4) & 0x3);
-
-            const auto tc = ((aBoard >> 14) & 0x3);
-            const auto cc = ((aBoard >> 8) & 0x3);
-            const auto bc = ((aBoard >> 2) & 0x3);
-
-            const auto tr = ((aBoard >> 12) & 0x3);
-            const auto cr = ((aBoard >> 6) & 0x3);
-            const auto br = (aBoard & 0x3);
-
-            const auto movingPlayerId = static_cast<uint32_t>(aMovingPlayer);
-            const auto otherPlayerId = (~movingPlayerId) & 0x3;
-
-            const uint32_t verticalShiftIndex = (tl > 0 && tl == cl && cl == bl) |
-                                                ((tc > 0 && tc == cc && cc == bc) << 1) |
-                                                ((tr > 0 && tr == cr && cr == br) << 2);
-
-            assert((
-                           verticalShiftIndex == 0 ||
-                           verticalShiftIndex == 1 ||
-                           verticalShiftIndex == 2 ||
-                           verticalShiftIndex == 4) && "More than one vertical Tris found!");
-
-            const auto verticalCheck = ((aBoard >> checkOffsets[verticalShiftIndex]) & 0x3);
-
-            if (verticalCheck == movingPlayerId)
-            {
-                return BoardStatus::Win;
-            }
-            else if (verticalCheck == otherPlayerId)
-            {
-                return BoardStatus::Lose;
-            }
-
-            const uint32_t horizontalShiftIndex = (tl > 0 && tl == tc && tc == tr) |
-                                                  ((cl > 0 && cl == cc && cc == cr) << 1) |
-                                                  ((bl > 0 && bl == bc && bc == br) << 2);
-
-            assert((
-                           horizontalShiftIndex == 0 ||
-                           horizontalShiftIndex == 1 ||
-                           horizontalShiftIndex == 2 ||
-                           horizontalShiftIndex == 4) && "More than one horizontal Tris found!");
-
-            const auto horizontalCheck = ((aBoard >> checkOffsets[horizontalShiftIndex]) & 0x3);
-
-            if (horizontalCheck == movingPlayerId)
-            {
-                return BoardStatus::Win;
-            }
-            else if (horizontalCheck == otherPlayerId)
-            {
-                return BoardStatus::Lose;
-            }
-
-            const uint32_t diagonalsShiftIndex = (tl > 0 && tl == cc && cc == br) |
-                                                 ((tr > 0 && tr == cc && cc == bl) << 1);
-
-            assert((
-                           diagonalsShiftIndex >= 0 &&
-                           diagonalsShiftIndex < 4));
-
-            const auto diagonalsCheck = ((aBoard >> checkOffsets[diagonalsShiftIndex]) & 0x3);
-
-            if (diagonalsCheck == movingPlayerId)
-            {
-                return BoardStatus::Win;
-            }
-            else if (diagonalsCheck == otherPlayerId)
-            {
-                return BoardStatus::Lose;
-            }
-
-            if (tl > 0 && cl > 0 && bl > 0 && tc > 0 && cc > 0 && bc > 0 && tr > 0 && cr > 0 && br > 0)
-            {
-                return BoardStatus::Draw;
-            }
-
-            return BoardStatus::Intermediate;
-        }
-
-        std::vector<uint32_t> GenerateMoves(const Player aPlayerToMove, const uint32_t aCurrentBoard)
+        void GenerateBoards(const Player anAgentPlayer, const Player aStartingPlayer, std::set<uint32_t>& someOutValidBoards)
         {
-            assert(GetBoardStatus(aPlayerToMove, aCurrentBoard) == BoardStatus::Intermediate &&
-                   "Cannot generate moves from a full board");
+            const auto& stateGraph = StateGraph::GetInstance();
 
-            std::vector<uint32_t> moves;
+#ifdef DEBUG_FLAG
+            // Validate the boards space once per process
+            static const auto isBoardsSpaceValid = [&]() {
+                std::set<uint32_t> fullBoardsSpace;
 
-            for (auto positionIndex = 0; positionIndex < 18; positionIndex += 2)
-            {
-                if (((aCurrentBoard >> positionIndex) & 0x3) == 0)
+                for (const auto movingPlayer : { Player::Cross, Player::Nought })
                 {
-                    const auto modifiedBoard = aCurrentBoard | (static_cast<uint32_t>(aPlayerToMove) << positionIndex);
-                    moves.push_back(modifiedBoard);
+                    for (const auto stateIndex : stateGraph.GetMoveResults(movingPlayer, Player::Cross))
+                    {
+                        fullBoardsSpace.insert(stateGraph.GetBoard(stateIndex));
+                    }
                 }
-            }
 
-            return moves;
-        }
+                // Check that the total number of legal boards is correct
+                assert(fullBoardsSpace.size() == 5477 && "The number of generated boards is not correct");
 
-        void GenerateBoards(const Player anAgentPlayer, const Player aStartingPlayer, std::set<uint32_t>& someOutValidBoards)
-        {
-            constexpr auto startingBoard = 0x00000000;
-
-            RecursiveBoardsGeneration(anAgentPlayer, aStartingPlayer, startingBoard, someOutValidBoards);
-
-#ifdef DEBUG_FLAG
-            // Check that the total number of legal boards is correct
-            std::set<uint32_t> fullBoardsSpace;
+                // Check that the total number of end games is correct
+                const auto endgamesCount = std::count_if(fullBoardsSpace.begin(), fullBoardsSpace.end(), [&](const auto aBoard) {
+                    return GetBoardStatus(Player::Cross, aBoard) != BoardStatus::Intermediate;
+                });
 
-            RecursiveBoardsGeneration(anAgentPlayer, Player::Cross, startingBoard, fullBoardsSpace);
+                assert(endgamesCount == 958 && "The number of generated end game boards is not correct");
 
-            // Compute the other player
-            const auto otherPlayer = static_cast<Player>((~static_cast<uint32_t>(anAgentPlayer)) & 0x3);
+                // Check that the occupancy masks evaluation agrees with the cell by cell one
+                assert(std::all_of(fullBoardsSpace.begin(), fullBoardsSpace.end(), [&](const auto aBoard) {
+                    return GetBoardStatus(Player::Cross, aBoard) == GetBoardStatusReference(Player::Cross, aBoard) &&
+                           GetBoardStatus(Player::Nought, aBoard) == GetBoardStatusReference(Player::Nought, aBoard);
+                }) && "The fast board status evaluation disagrees with the reference one");
 
-            RecursiveBoardsGeneration(otherPlayer, Player::Cross, startingBoard, fullBoardsSpace);
+                return endgamesCount == 958;
+            }();
 
-            assert(fullBoardsSpace.size() == 5477 && "The number of generated boards is not correct");
-
-            // Check that the total number of end games is correct
-            const auto endgamesCount = std::count_if(fullBoardsSpace.begin(), fullBoardsSpace.end(), [&](const auto aBoard) {
-                return GetBoardStatus(Player::Cross, aBoard) != BoardStatus::Intermediate;
-            });
-
-            assert(endgamesCount == 958 && "The number of generated end game boards is not correct");
+            (void) isBoardsSpaceValid;
 #endif
+
+            for (const auto stateIndex : stateGraph.GetMoveResults(anAgentPlayer, aStartingPlayer))
+            {
+                someOutValidBoards.insert(stateGraph.GetBoard(stateIndex));
+            }
         }
     }
 }
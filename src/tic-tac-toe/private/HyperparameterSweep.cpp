@@ -0,0 +1,271 @@
+//
+// Created by Gianmarco Picarella on 17/10/22.
+//
+
+#include "HyperparameterSweep.h"
+
+#include "EpisodeObservers.h"
+#include "EpsilonOptimalOpponent.h"
+#include "GameUtils.h"
+#include "RandomOpponent.h"
+#include "StaticTicTacToeQLearner.h"
+
+#include <algorithm>
+#include <atomic>
+#include <cassert>
+#include <chrono>
+#include <cstdio>
+#include <thread>
+
+namespace TTT
+{
+namespace Utils
+{
+    namespace
+    {
+        TicTacToeSettings<BoardStatus> MakeLearningSettings(const SweepConfiguration& aConfiguration, const SweepSettings& someSweepSettings)
+        {
+            TicTacToeSettings<BoardStatus> learningSettings;
+
+            learningSettings.myGamma = aConfiguration.myGamma;
+            learningSettings.myRandomEpsilon = aConfiguration.myRandomEpsilon;
+            learningSettings.myRandomEpsilonDecay = aConfiguration.myRandomEpsilonDecay;
+            learningSettings.myLearningRate = aConfiguration.myLearningRate;
+            learningSettings.myIsTraining = true;
+            learningSettings.myIsAgentDelayed = someSweepSettings.myIsAgentDelayed;
+
+            learningSettings.myStaticScores[BoardStatus::Win] = aConfiguration.myRewards[0];
+            learningSettings.myStaticScores[BoardStatus::Draw] = aConfiguration.myRewards[1];
+            learningSettings.myStaticScores[BoardStatus::Lose] = aConfiguration.myRewards[2];
+            learningSettings.myStaticScores[BoardStatus::Intermediate] = aConfiguration.myRewards[3];
+
+            return learningSettings;
+        }
+
+        template <typename Opponent>
+        void EvaluateAgent(StaticTicTacToeQLearner& anAgent, Opponent& anOpponent, const SweepSettings& someSweepSettings,
+                           int (&anOutResults)[4])
+        {
+            const auto agentSide = anAgent.GetAgentId();
+
+            Simulate(anAgent, anOpponent, someSweepSettings.myEvaluationEpisodesCount, !someSweepSettings.myIsAgentDelayed,
+                     MakeCallbackEpisodeObserver([&](const std::vector<uint32_t>& aGameplayHistory, int) {
+                         ++anOutResults[static_cast<uint32_t>(GetBoardStatus(agentSide, aGameplayHistory.back()))];
+                     }));
+        }
+
+        SweepResult RunConfiguration(int aConfigurationIndex, const SweepConfiguration& aConfiguration, const SweepSettings& someSweepSettings)
+        {
+            const auto opponentSide = static_cast<Player>((~static_cast<uint32_t>(someSweepSettings.myAgentSide)) & 0x3);
+            const auto firstStream = 4 * static_cast<uint64_t>(aConfigurationIndex);
+
+            SweepResult result;
+            result.myConfigurationIndex = aConfigurationIndex;
+            result.myConfiguration = aConfiguration;
+
+            StaticTicTacToeQLearner agent { someSweepSettings.myAgentSide, MakeLearningSettings(aConfiguration, someSweepSettings) };
+            agent.SetRandomGenerator(RL::RandomGenerator { someSweepSettings.mySeed, firstStream });
+
+            const auto trainingStartTime = std::chrono::steady_clock::now();
+
+            if (someSweepSettings.myTrainingOpponentEpsilon < 0.f)
+            {
+                RandomOpponent trainingOpponent { opponentSide };
+                trainingOpponent.SetRandomGenerator(RL::RandomGenerator { someSweepSettings.mySeed, firstStream + 1 });
+
+                Simulate(agent, trainingOpponent, someSweepSettings.myTrainingEpisodesCount, !someSweepSettings.myIsAgentDelayed);
+            }
+            else
+            {
+                EpsilonOptimalOpponent trainingOpponent { opponentSide, someSweepSettings.myTrainingOpponentEpsilon };
+                trainingOpponent.SetRandomGenerator(RL::RandomGenerator { someSweepSettings.mySeed, firstStream + 1 });
+
+                Simulate(agent, trainingOpponent, someSweepSettings.myTrainingEpisodesCount, !someSweepSettings.myIsAgentDelayed);
+            }
+
+            result.myTrainingSeconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - trainingStartTime).count();
+
+            agent.SetTrainingMode(false);
+
+            RandomOpponent randomOpponent { opponentSide };
+            randomOpponent.SetRandomGenerator(RL::RandomGenerator { someSweepSettings.mySeed, firstStream + 2 });
+
+            EvaluateAgent(agent, randomOpponent, someSweepSettings, result.myRandomOpponentResults);
+
+            EpsilonOptimalOpponent optimalOpponent { opponentSide, 0.f };
+            optimalOpponent.SetRandomGenerator(RL::RandomGenerator { someSweepSettings.mySeed, firstStream + 3 });
+
+            EvaluateAgent(agent, optimalOpponent, someSweepSettings, result.myOptimalOpponentResults);
+
+            const auto getMeanOutcome = [&](const int (&someResults)[4]) {
+                return someSweepSettings.myEvaluationEpisodesCount > 0 ?
+                       static_cast<double>(someResults[static_cast<uint32_t>(BoardStatus::Win)] - someResults[static_cast<uint32_t>(BoardStatus::Lose)]) /
+                       someSweepSettings.myEvaluationEpisodesCount : 0.0;
+            };
+
+            result.myScore = 0.5 * (getMeanOutcome(result.myRandomOpponentResults) + getMeanOutcome(result.myOptimalOpponentResults));
+
+            return result;
+        }
+
+        float DrawBetween(const std::vector<float>& someValues, RL::RandomGenerator& aRandomGenerator)
+        {
+            assert(!someValues.empty());
+
+            const auto minMax = std::minmax_element(someValues.begin(), someValues.end());
+
+            return *minMax.first + aRandomGenerator.NextFloat() * (*minMax.second - *minMax.first);
+        }
+    }
+
+    std::vector<SweepConfiguration> MakeGridConfigurations(const SweepSpace& aSweepSpace)
+    {
+        std::vector<SweepConfiguration> configurations;
+
+        for (const auto gamma : aSweepSpace.myGammas)
+        {
+            for (const auto randomEpsilon : aSweepSpace.myRandomEpsilons)
+            {
+                for (const auto randomEpsilonDecay : aSweepSpace.myRandomEpsilonDecays)
+                {
+                    for (const auto learningRate : aSweepSpace.myLearningRates)
+                    {
+                        for (const auto& rewards : aSweepSpace.myRewards)
+                        {
+                            configurations.push_back(SweepConfiguration { gamma, randomEpsilon, randomEpsilonDecay, learningRate, rewards });
+                        }
+                    }
+                }
+            }
+        }
+
+        return configurations;
+    }
+
+    std::vector<SweepConfiguration> MakeRandomConfigurations(const SweepSpace& aSweepSpace, int aConfigurationsCount,
+                                                             RL::RandomGenerator& aRandomGenerator)
+    {
+        assert(!aSweepSpace.myRewards.empty());
+
+        std::vector<SweepConfiguration> configurations(static_cast<std::size_t>(std::max(0, aConfigurationsCount)));
+
+        for (auto& configuration : configurations)
+        {
+            configuration.myGamma = DrawBetween(aSweepSpace.myGammas, aRandomGenerator);
+            configuration.myRandomEpsilon = DrawBetween(aSweepSpace.myRandomEpsilons, aRandomGenerator);
+            configuration.myRandomEpsilonDecay = DrawBetween(aSweepSpace.myRandomEpsilonDecays, aRandomGenerator);
+            configuration.myLearningRate = DrawBetween(aSweepSpace.myLearningRates, aRandomGenerator);
+            configuration.myRewards = aSweepSpace.myRewards[aRandomGenerator.NextIndex(aSweepSpace.myRewards.size())];
+        }
+
+        return configurations;
+    }
+
+    std::vector<SweepResult> RunSweep(const std::vector<SweepConfiguration>& someConfigurations, const SweepSettings& someSweepSettings,
+                                      const std::function<void(const SweepResult&)>& aConfigurationDoneCallback)
+    {
+        std::vector<SweepResult> results(someConfigurations.size());
+        std::atomic<std::size_t> nextConfigurationIndex { 0 };
+
+        const auto runWorker = [&]() {
+            for (auto configurationIndex = nextConfigurationIndex++; configurationIndex < someConfigurations.size();
+                 configurationIndex = nextConfigurationIndex++)
+            {
+                results[configurationIndex] = RunConfiguration(static_cast<int>(configurationIndex), someConfigurations[configurationIndex],
+                                                               someSweepSettings);
+
+                if (aConfigurationDoneCallback)
+                {
+                    aConfigurationDoneCallback(results[configurationIndex]);
+                }
+            }
+        };
+
+        // Built before the workers start, so that none of them waits on the first access
+        SolvedGameTable::GetInstance();
+
+        const auto threadsCount = std::max(1, std::min(someSweepSettings.myThreadsCount, static_cast<int>(someConfigurations.size())));
+
+        std::vector<std::thread> workers;
+
+        for (auto workerIndex = 1; workerIndex < threadsCount; ++workerIndex)
+        {
+            workers.emplace_back(runWorker);
+        }
+
+        runWorker();
+
+        for (auto& worker : workers)
+        {
+            worker.join();
+        }
+
+        // Ties keep the configurations order
+        std::stable_sort(results.begin(), results.end(), [](const SweepResult& aResult, const SweepResult& anOtherResult) {
+            return aResult.myScore > anOtherResult.myScore;
+        });
+
+        return results;
+    }
+
+    bool SaveSweepResults(const std::vector<SweepResult>& someSweepResults, const std::string& aPath)
+    {
+        auto* resultsFile = std::fopen(aPath.c_str(), "w");
+
+        if (resultsFile == nullptr)
+        {
+            return false;
+        }
+
+        const auto isCsv = aPath.size() >= 4 && aPath.compare(aPath.size() - 4, 4, ".csv") == 0;
+
+        constexpr auto win = static_cast<uint32_t>(BoardStatus::Win);
+        constexpr auto draw = static_cast<uint32_t>(BoardStatus::Draw);
+        constexpr auto lose = static_cast<uint32_t>(BoardStatus::Lose);
+
+        if (isCsv)
+        {
+            std::fprintf(resultsFile, "rank,configuration,gamma,epsilon,epsilon_decay,learning_rate,win_reward,draw_reward,lose_reward,"
+                                      "intermediate_reward,training_seconds,random_wins,random_draws,random_loses,"
+                                      "optimal_wins,optimal_draws,optimal_loses,score\n");
+        }
+        else
+        {
+            std::fprintf(resultsFile, "[\n");
+        }
+
+        for (std::size_t rank = 0; rank < someSweepResults.size(); ++rank)
+        {
+            const auto& result = someSweepResults[rank];
+            const auto& configuration = result.myConfiguration;
+
+            const auto* format = isCsv ?
+                    "%zu,%d,%g,%g,%g,%g,%g,%g,%g,%g,%.3f,%d,%d,%d,%d,%d,%d,%.6f\n" :
+                    "  {\"rank\": %zu, \"configuration\": %d, \"gamma\": %g, \"epsilon\": %g, \"epsilon_decay\": %g, "
+                    "\"learning_rate\": %g, \"rewards\": [%g, %g, %g, %g], \"training_seconds\": %.3f, "
+                    "\"random_opponent\": {\"wins\": %d, \"draws\": %d, \"loses\": %d}, "
+                    "\"optimal_opponent\": {\"wins\": %d, \"draws\": %d, \"loses\": %d}, \"score\": %.6f}";
+
+            std::fprintf(resultsFile, format, rank + 1, result.myConfigurationIndex,
+                         configuration.myGamma, configuration.myRandomEpsilon, configuration.myRandomEpsilonDecay, configuration.myLearningRate,
+                         configuration.myRewards[0], configuration.myRewards[1], configuration.myRewards[2], configuration.myRewards[3],
+                         result.myTrainingSeconds,
+                         result.myRandomOpponentResults[win], result.myRandomOpponentResults[draw], result.myRandomOpponentResults[lose],
+                         result.myOptimalOpponentResults[win], result.myOptimalOpponentResults[draw], result.myOptimalOpponentResults[lose],
+                         result.myScore);
+
+            if (!isCsv)
+            {
+                std::fprintf(resultsFile, rank + 1 < someSweepResults.size() ? ",\n" : "\n");
+            }
+        }
+
+        if (!isCsv)
+        {
+            std::fprintf(resultsFile, "]\n");
+        }
+
+        return std::fclose(resultsFile) == 0;
+    }
+}
+}
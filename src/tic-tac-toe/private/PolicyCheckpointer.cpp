@@ -0,0 +1,140 @@
+//
+// Created by Gianmarco Picarella on 17/10/22.
+//
+
+#include "PolicyCheckpointer.h"
+
+namespace TTT
+{
+namespace Utils
+{
+    PolicyCheckpointer::PolicyCheckpointer(const TicTacToeQLearner& aLearner, const std::string& aPath, const PolicyFormat aFormat,
+                                           int anEpisodesInterval, double aSecondsInterval) :
+            myLearner(&aLearner),
+            myPath(aPath),
+            myFormat(aFormat),
+            myEpisodesInterval(anEpisodesInterval),
+            mySecondsInterval(std::chrono::duration_cast<std::chrono::steady_clock::duration>(std::chrono::duration<double>(aSecondsInterval))),
+            myEpisodesSinceCheckpoint(0),
+            myLastCheckpointTime(std::chrono::steady_clock::now()),
+            mySnapshotAgentId(aLearner.GetAgentId()),
+            mySnapshotSlotValues(aLearner.GetActionValueScores().GetBoardSlotMapper().GetSlotsCount()),
+            myIsSnapshotPending(false),
+            myIsStopping(false),
+            myWrittenCheckpointsCount(0),
+            myFailedCheckpointsCount(0)
+    {
+        if (myEpisodesInterval > 0 || mySecondsInterval.count() > 0)
+        {
+            myWriterThread = std::thread(&PolicyCheckpointer::WriteLoop, this);
+        }
+    }
+
+    PolicyCheckpointer::~PolicyCheckpointer()
+    {
+        Stop();
+    }
+
+    void PolicyCheckpointer::OnEpisodesSummary(const EpisodesSummary& aSummary)
+    {
+        myEpisodesSinceCheckpoint += aSummary.myEpisodesCount;
+
+        if (!myWriterThread.joinable())
+        {
+            return;
+        }
+
+        const auto isEpisodesIntervalElapsed = myEpisodesInterval > 0 && myEpisodesSinceCheckpoint >= myEpisodesInterval;
+        const auto isSecondsIntervalElapsed = mySecondsInterval.count() > 0 &&
+                                              std::chrono::steady_clock::now() - myLastCheckpointTime >= mySecondsInterval;
+
+        if (!isEpisodesIntervalElapsed && !isSecondsIntervalElapsed)
+        {
+            return;
+        }
+
+        {
+            std::lock_guard<std::mutex> lock(mySnapshotMutex);
+
+            if (myIsSnapshotPending || myIsStopping)
+            {
+                return;
+            }
+        }
+
+        // The writer does not read the snapshot until it is pending again
+        const auto& actionValueScores = myLearner->GetActionValueScores();
+
+        mySnapshotAgentId = myLearner->GetAgentId();
+        mySnapshotSettings = myLearner->GetLearningSettings();
+        mySnapshotBoardSlotMapper = actionValueScores.GetBoardSlotMapper();
+        mySnapshotSlotValues.assign(actionValueScores.GetSlotValues(), actionValueScores.GetSlotValues() + mySnapshotBoardSlotMapper.GetSlotsCount());
+
+        // Saved policies do not include the replay buffer, the restored learner does not need to allocate one
+        mySnapshotSettings.myReplayCapacity = 0;
+
+        {
+            std::lock_guard<std::mutex> lock(mySnapshotMutex);
+            myIsSnapshotPending = true;
+        }
+
+        mySnapshotCondition.notify_one();
+
+        myEpisodesSinceCheckpoint = 0;
+        myLastCheckpointTime = std::chrono::steady_clock::now();
+    }
+
+    void PolicyCheckpointer::Stop()
+    {
+        {
+            std::lock_guard<std::mutex> lock(mySnapshotMutex);
+            myIsStopping = true;
+        }
+
+        mySnapshotCondition.notify_one();
+
+        if (myWriterThread.joinable())
+        {
+            myWriterThread.join();
+        }
+    }
+
+    int PolicyCheckpointer::GetWrittenCheckpointsCount() const
+    {
+        std::lock_guard<std::mutex> lock(mySnapshotMutex);
+        return myWrittenCheckpointsCount;
+    }
+
+    int PolicyCheckpointer::GetFailedCheckpointsCount() const
+    {
+        std::lock_guard<std::mutex> lock(mySnapshotMutex);
+        return myFailedCheckpointsCount;
+    }
+
+    void PolicyCheckpointer::WriteLoop()
+    {
+        std::unique_lock<std::mutex> lock(mySnapshotMutex);
+
+        while (true)
+        {
+            mySnapshotCondition.wait(lock, [this]() { return myIsSnapshotPending || myIsStopping; });
+
+            // A pending snapshot is still written when stopping
+            if (!myIsSnapshotPending)
+            {
+                return;
+            }
+
+            lock.unlock();
+
+            const TicTacToeQLearner snapshot { mySnapshotAgentId, mySnapshotSettings, mySnapshotBoardSlotMapper, mySnapshotSlotValues.data() };
+            const auto isSaved = SavePolicyAtomically(snapshot, myPath, myFormat);
+
+            lock.lock();
+
+            ++(isSaved ? myWrittenCheckpointsCount : myFailedCheckpointsCount);
+            myIsSnapshotPending = false;
+        }
+    }
+}
+}
@@ -0,0 +1,143 @@
+//
+// Created by Gianmarco Picarella on 17/10/22.
+//
+
+#include "PolicyEvaluation.h"
+
+#include "GameUtils.h"
+#include "QLearnerJobs.h"
+#include "SolvedGameTable.h"
+#include "StateGraph.h"
+
+#include <algorithm>
+#include <array>
+#include <cassert>
+#include <vector>
+
+namespace TTT
+{
+namespace Utils
+{
+    namespace
+    {
+        using OutcomeProbabilities = std::array<double, 4>;
+
+        class PolicyEvaluator
+        {
+        public:
+            PolicyEvaluator(const TicTacToeQLearner& aLearner, float anOpponentRandomEpsilon) :
+                    myLearner(aLearner),
+                    myStateGraph(StateGraph::GetInstance()),
+                    mySolvedGameTable(anOpponentRandomEpsilon < 1.f ? &SolvedGameTable::GetInstance() : nullptr),
+                    myAgentId(aLearner.GetAgentId()),
+                    myOpponentId(static_cast<Player>((~static_cast<uint32_t>(myAgentId)) & 0x3)),
+                    myOpponentRandomEpsilon(anOpponentRandomEpsilon),
+                    myOutcomeProbabilities(myStateGraph.GetStatesCount()),
+                    myIsEvaluated(myStateGraph.GetStatesCount(), false),
+                    myEvaluatedStatesCount(0)
+            {
+            }
+
+            // Outcome probabilities of the games going on from a state, computed once per state: with a given starting
+            // player, the player to move only depends on the state
+            const OutcomeProbabilities& Evaluate(const uint32_t aStateIndex, const Player aPlayerToMove)
+            {
+                if (myIsEvaluated[aStateIndex])
+                {
+                    return myOutcomeProbabilities[aStateIndex];
+                }
+
+                auto& outcomeProbabilities = myOutcomeProbabilities[aStateIndex];
+                outcomeProbabilities.fill(0.0);
+
+                if (myStateGraph.IsTerminal(aStateIndex))
+                {
+                    outcomeProbabilities[static_cast<uint32_t>(myStateGraph.GetStatus(aStateIndex, myAgentId))] = 1.0;
+                }
+                else if (aPlayerToMove == myAgentId)
+                {
+                    auto maxValue = 0.f;
+                    const auto greedyMoves = GetGreedyMoves(myLearner.GetActionValueScores(), myAgentId, myStateGraph.GetBoard(aStateIndex), maxValue);
+
+                    for (const auto greedyMove : greedyMoves)
+                    {
+                        AddWeighted(outcomeProbabilities, Evaluate(myStateGraph.GetStateIndex(greedyMove), myOpponentId), 1.0 / greedyMoves.size());
+                    }
+                }
+                else
+                {
+                    const auto opponentStates = myStateGraph.GetSuccessors(aStateIndex, myOpponentId);
+                    const auto optimalMoves = mySolvedGameTable != nullptr ?
+                                              mySolvedGameTable->GetOptimalMoves(myStateGraph.GetBoard(aStateIndex), myOpponentId) : MoveList{};
+
+                    for (const auto opponentStateIndex : opponentStates)
+                    {
+                        auto probability = static_cast<double>(myOpponentRandomEpsilon) / opponentStates.size();
+
+                        if (std::find(optimalMoves.begin(), optimalMoves.end(), myStateGraph.GetBoard(opponentStateIndex)) != optimalMoves.end())
+                        {
+                            probability += (1.0 - myOpponentRandomEpsilon) / optimalMoves.size();
+                        }
+
+                        if (probability > 0.0)
+                        {
+                            AddWeighted(outcomeProbabilities, Evaluate(opponentStateIndex, myAgentId), probability);
+                        }
+                    }
+                }
+
+                myIsEvaluated[aStateIndex] = true;
+                ++myEvaluatedStatesCount;
+
+                return outcomeProbabilities;
+            }
+
+            uint32_t GetEvaluatedStatesCount() const { return myEvaluatedStatesCount; }
+
+        private:
+            static void AddWeighted(OutcomeProbabilities& anOutProbabilities, const OutcomeProbabilities& someProbabilities, double aWeight)
+            {
+                for (std::size_t statusIndex = 0; statusIndex < anOutProbabilities.size(); ++statusIndex)
+                {
+                    anOutProbabilities[statusIndex] += aWeight * someProbabilities[statusIndex];
+                }
+            }
+
+            const TicTacToeQLearner& myLearner;
+            const StateGraph& myStateGraph;
+            const SolvedGameTable* mySolvedGameTable;
+
+            Player myAgentId;
+            Player myOpponentId;
+            float myOpponentRandomEpsilon;
+
+            // Indexed by state
+            std::vector<OutcomeProbabilities> myOutcomeProbabilities;
+            std::vector<bool> myIsEvaluated;
+            uint32_t myEvaluatedStatesCount;
+        };
+    }
+
+    PolicyEvaluationResult EvaluatePolicy(const TicTacToeQLearner& aLearner, float anOpponentRandomEpsilon)
+    {
+        assert(anOpponentRandomEpsilon >= 0.f && anOpponentRandomEpsilon <= 1.f);
+
+        const auto& stateGraph = StateGraph::GetInstance();
+
+        const auto agentId = aLearner.GetAgentId();
+        const auto opponentId = static_cast<Player>((~static_cast<uint32_t>(agentId)) & 0x3);
+        const auto startingPlayer = aLearner.GetLearningSettings().myIsAgentDelayed ? opponentId : agentId;
+
+        PolicyEvaluator policyEvaluator { aLearner, anOpponentRandomEpsilon };
+
+        const auto& outcomeProbabilities = policyEvaluator.Evaluate(stateGraph.GetStateIndex(0x00000000u), startingPlayer);
+
+        PolicyEvaluationResult result;
+
+        std::copy(outcomeProbabilities.begin(), outcomeProbabilities.end(), result.myOutcomeProbabilities);
+        result.myEvaluatedStatesCount = policyEvaluator.GetEvaluatedStatesCount();
+
+        return result;
+    }
+}
+}
@@ -0,0 +1,262 @@
+//
+// Created by Gianmarco Picarella on 16/10/22.
+//
+
+#include "PolicySerialization.h"
+
+#include <cereal/archives/json.hpp>
+
+#include <cassert>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <vector>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace TTT
+{
+    namespace
+    {
+        constexpr char PolicyFileMagic[8] = { 'T', 'T', 'T', 'P', 'O', 'L', 'I', 'C' };
+
+        // Values start on their own cache line
+        constexpr uint32_t PolicyValuesOffset = (sizeof(PolicyFileHeader) + 63) / 64 * 64;
+
+        constexpr BoardStatus AllBoardStatuses[] = { BoardStatus::Intermediate, BoardStatus::Draw, BoardStatus::Win, BoardStatus::Lose };
+
+        bool IsSupportedHeader(const PolicyFileHeader& aHeader, const std::size_t aFileSize)
+        {
+            Utils::BoardSlotMapper boardSlotMapper;
+            boardSlotMapper.SetMapping(aHeader.myIsSymmetryReduced != 0, aHeader.myIsColourSwapped != 0);
+
+            return std::memcmp(aHeader.myMagic, PolicyFileMagic, sizeof(PolicyFileMagic)) == 0 &&
+                   aHeader.myVersion == PolicyFileHeader::CurrentVersion &&
+                   aHeader.myByteOrderMark == PolicyFileHeader::ByteOrderMark &&
+                   aHeader.mySlotsCount == boardSlotMapper.GetSlotsCount() &&
+                   aHeader.myValuesOffset % alignof(float) == 0 &&
+                   aHeader.myValuesOffset + aHeader.mySlotsCount * sizeof(float) <= aFileSize;
+        }
+
+        bool SaveBinaryPolicy(const TicTacToeQLearner& aLearner, const std::string& aPath)
+        {
+            const auto& learningSettings = aLearner.GetLearningSettings();
+            const auto& actionValueScores = aLearner.GetActionValueScores();
+
+            PolicyFileHeader header {};
+
+            std::memcpy(header.myMagic, PolicyFileMagic, sizeof(PolicyFileMagic));
+            header.myVersion = PolicyFileHeader::CurrentVersion;
+            header.myByteOrderMark = PolicyFileHeader::ByteOrderMark;
+            header.myValuesOffset = PolicyValuesOffset;
+            header.mySlotsCount = actionValueScores.GetBoardSlotMapper().GetSlotsCount();
+
+            header.myAgentId = static_cast<uint32_t>(aLearner.GetAgentId());
+            header.myIsTraining = learningSettings.myIsTraining;
+            header.myIsAgentDelayed = learningSettings.myIsAgentDelayed;
+            header.myUseSymmetries = learningSettings.myUseSymmetries;
+            header.myShareSidesTable = learningSettings.myShareSidesTable;
+            header.myIsSymmetryReduced = actionValueScores.GetBoardSlotMapper().IsSymmetryReduced();
+            header.myIsColourSwapped = actionValueScores.GetBoardSlotMapper().IsColourSwapped();
+
+            header.myLearningRate = learningSettings.myLearningRate;
+            header.myGamma = learningSettings.myGamma;
+            header.myRandomEpsilon = learningSettings.myRandomEpsilon;
+            header.myRandomEpsilonDecay = learningSettings.myRandomEpsilonDecay;
+
+            for (const auto boardStatus : AllBoardStatuses)
+            {
+                const auto staticScore = learningSettings.myStaticScores.find(boardStatus);
+                header.myStaticScores[static_cast<uint32_t>(boardStatus)] = staticScore != learningSettings.myStaticScores.end() ? staticScore->second : 0.f;
+            }
+
+            std::ofstream serializeStream(aPath, std::ios::binary | std::ios::trunc);
+
+            if (!serializeStream.is_open())
+            {
+                return false;
+            }
+
+            const std::vector<char> headerPadding(PolicyValuesOffset - sizeof(PolicyFileHeader), 0);
+
+            serializeStream.write(reinterpret_cast<const char*>(&header), sizeof(PolicyFileHeader));
+            serializeStream.write(headerPadding.data(), headerPadding.size());
+            serializeStream.write(reinterpret_cast<const char*>(actionValueScores.GetSlotValues()), header.mySlotsCount * sizeof(float));
+            serializeStream.close();
+
+            return !serializeStream.fail();
+        }
+    }
+
+    MappedPolicyFile::MappedPolicyFile(const std::string& aPath) :
+            myMapping(nullptr),
+            myMappingSize(0),
+            myHeader(nullptr),
+            mySlotValues(nullptr)
+    {
+        const auto fileDescriptor = open(aPath.c_str(), O_RDONLY);
+
+        if (fileDescriptor < 0)
+        {
+            return;
+        }
+
+        struct stat fileStatus;
+
+        if (fstat(fileDescriptor, &fileStatus) == 0 && static_cast<std::size_t>(fileStatus.st_size) >= sizeof(PolicyFileHeader))
+        {
+            myMappingSize = static_cast<std::size_t>(fileStatus.st_size);
+            myMapping = mmap(nullptr, myMappingSize, PROT_READ, MAP_PRIVATE, fileDescriptor, 0);
+
+            if (myMapping == MAP_FAILED)
+            {
+                myMapping = nullptr;
+            }
+        }
+
+        // The mapping stays valid once the descriptor is closed
+        close(fileDescriptor);
+
+        if (myMapping == nullptr)
+        {
+            return;
+        }
+
+        const auto* header = static_cast<const PolicyFileHeader*>(myMapping);
+
+        if (IsSupportedHeader(*header, myMappingSize))
+        {
+            myHeader = header;
+            mySlotValues = reinterpret_cast<const float*>(static_cast<const char*>(myMapping) + header->myValuesOffset);
+            myBoardSlotMapper.SetMapping(header->myIsSymmetryReduced != 0, header->myIsColourSwapped != 0);
+        }
+    }
+
+    MappedPolicyFile::~MappedPolicyFile()
+    {
+        if (myMapping != nullptr)
+        {
+            munmap(myMapping, myMappingSize);
+        }
+    }
+
+    TicTacToeSettings<BoardStatus> MappedPolicyFile::GetLearningSettings() const
+    {
+        assert(IsValid());
+
+        TicTacToeSettings<BoardStatus> learningSettings;
+
+        learningSettings.myIsTraining = myHeader->myIsTraining != 0;
+        learningSettings.myIsAgentDelayed = myHeader->myIsAgentDelayed != 0;
+        learningSettings.myUseSymmetries = myHeader->myUseSymmetries != 0;
+        learningSettings.myShareSidesTable = myHeader->myShareSidesTable != 0;
+
+        learningSettings.myLearningRate = myHeader->myLearningRate;
+        learningSettings.myGamma = myHeader->myGamma;
+        learningSettings.myRandomEpsilon = myHeader->myRandomEpsilon;
+        learningSettings.myRandomEpsilonDecay = myHeader->myRandomEpsilonDecay;
+
+        for (const auto boardStatus : AllBoardStatuses)
+        {
+            learningSettings.myStaticScores[boardStatus] = myHeader->myStaticScores[static_cast<uint32_t>(boardStatus)];
+        }
+
+        return learningSettings;
+    }
+
+namespace Utils
+{
+    PolicyFormat GetPolicyFormat(const std::string& aPath)
+    {
+        const std::string binaryExtension(PolicyBinaryExtension);
+
+        const auto isBinary = aPath.size() >= binaryExtension.size() &&
+                              aPath.compare(aPath.size() - binaryExtension.size(), binaryExtension.size(), binaryExtension) == 0;
+
+        return isBinary ? PolicyFormat::Binary : PolicyFormat::Json;
+    }
+
+    bool SavePolicy(const TicTacToeQLearner& aLearner, const std::string& aPath, const PolicyFormat aFormat)
+    {
+        if (aFormat == PolicyFormat::Binary)
+        {
+            return SaveBinaryPolicy(aLearner, aPath);
+        }
+
+        std::ofstream serializeStream(aPath);
+
+        if (!serializeStream.is_open())
+        {
+            return false;
+        }
+
+        {
+            // Same node name as the policies saved so far
+            cereal::JSONOutputArchive archive(serializeStream);
+            archive(cereal::make_nvp("*agentPtr", aLearner));
+        }
+
+        // The archive is only complete once destroyed
+        serializeStream.close();
+
+        return !serializeStream.fail();
+    }
+
+    bool SavePolicyAtomically(const TicTacToeQLearner& aLearner, const std::string& aPath, const PolicyFormat aFormat)
+    {
+        const auto temporaryPath = aPath + ".tmp";
+
+        // A partially written policy never replaces the previous one
+        if (!SavePolicy(aLearner, temporaryPath, aFormat))
+        {
+            std::remove(temporaryPath.c_str());
+            return false;
+        }
+
+        return std::rename(temporaryPath.c_str(), aPath.c_str()) == 0;
+    }
+
+    bool LoadPolicy(const std::string& aPath, const PolicyFormat aFormat, TicTacToeQLearner& anOutLearner)
+    {
+        if (aFormat == PolicyFormat::Binary)
+        {
+            const MappedPolicyFile policyFile(aPath);
+
+            if (!policyFile.IsValid())
+            {
+                return false;
+            }
+
+            anOutLearner = TicTacToeQLearner { policyFile.GetAgentId(), policyFile.GetLearningSettings(),
+                                               policyFile.GetBoardSlotMapper(), policyFile.GetSlotValues() };
+            return true;
+        }
+
+        std::ifstream deserializePath(aPath);
+
+        if (!deserializePath.is_open())
+        {
+            return false;
+        }
+
+        TicTacToeQLearner learner;
+
+        // Malformed or truncated files are reported by the archive
+        try
+        {
+            cereal::JSONInputArchive jsonArchive(deserializePath);
+            jsonArchive(learner);
+        }
+        catch (const cereal::Exception&)
+        {
+            return false;
+        }
+
+        anOutLearner = std::move(learner);
+        return true;
+    }
+}
+}
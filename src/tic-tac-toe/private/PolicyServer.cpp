@@ -0,0 +1,458 @@
+//
+// Created by Gianmarco Picarella on 17/10/22.
+//
+
+#include "PolicyServer.h"
+
+#include "GameUtils.h"
+
+#include <cassert>
+#include <algorithm>
+#include <cerrno>
+#include <chrono>
+#include <cstdio>
+#include <cstring>
+#include <limits>
+
+#include <fcntl.h>
+#include <poll.h>
+#include <signal.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+
+namespace TTT
+{
+    namespace
+    {
+        volatile sig_atomic_t isStopRequested = 0;
+
+        void RequestStop(int)
+        {
+            isStopRequested = 1;
+        }
+
+        // No SA_RESTART, a signal interrupts poll
+        void InstallSignalHandlers()
+        {
+            struct sigaction stopAction {};
+            stopAction.sa_handler = RequestStop;
+            sigemptyset(&stopAction.sa_mask);
+
+            sigaction(SIGINT, &stopAction, nullptr);
+            sigaction(SIGTERM, &stopAction, nullptr);
+
+            signal(SIGPIPE, SIG_IGN);
+        }
+
+        int OpenListeningSocket(const std::string& aSocketPath, const int aBacklog)
+        {
+            sockaddr_un socketAddress {};
+            socketAddress.sun_family = AF_UNIX;
+
+            if (aSocketPath.size() >= sizeof(socketAddress.sun_path))
+            {
+                return -1;
+            }
+
+            std::memcpy(socketAddress.sun_path, aSocketPath.c_str(), aSocketPath.size() + 1);
+
+            const auto listeningDescriptor = socket(AF_UNIX, SOCK_STREAM | SOCK_NONBLOCK | SOCK_CLOEXEC, 0);
+
+            if (listeningDescriptor < 0)
+            {
+                return -1;
+            }
+
+            unlink(aSocketPath.c_str());
+
+            if (bind(listeningDescriptor, reinterpret_cast<const sockaddr*>(&socketAddress), sizeof(socketAddress)) != 0 ||
+                listen(listeningDescriptor, aBacklog) != 0)
+            {
+                close(listeningDescriptor);
+                return -1;
+            }
+
+            return listeningDescriptor;
+        }
+
+        // 'x', 'o' and '.' cells in row-major order, false on any other request
+        bool ParseBoard(const char* aRequest, std::size_t aRequestSize, uint32_t& anOutBoard)
+        {
+            // Tolerate CRLF line endings
+            if (aRequestSize > 0 && aRequest[aRequestSize - 1] == '\r')
+            {
+                --aRequestSize;
+            }
+
+            if (aRequestSize != 9)
+            {
+                return false;
+            }
+
+            anOutBoard = 0;
+
+            for (auto cellIndex = 0; cellIndex < 9; ++cellIndex)
+            {
+                const auto cellShift = 16 - 2 * cellIndex;
+
+                switch (aRequest[cellIndex])
+                {
+                    case 'x': case 'X': anOutBoard |= static_cast<uint32_t>(Player::Cross) << cellShift; break;
+                    case 'o': case 'O': anOutBoard |= static_cast<uint32_t>(Player::Nought) << cellShift; break;
+                    case '.': case '-': break;
+                    default: return false;
+                }
+            }
+
+            return true;
+        }
+    }
+
+    PolicyServer::PolicyServer(const std::string& aPolicyPath, const PolicyFormat aFormat) :
+            myAgentId(Player::Cross),
+            myIsAgentDelayed(false),
+            mySlotValues(nullptr)
+    {
+        if (aFormat == PolicyFormat::Binary)
+        {
+            myMappedPolicy.reset(new MappedPolicyFile(aPolicyPath));
+
+            if (!myMappedPolicy->IsValid())
+            {
+                return;
+            }
+
+            myAgentId = myMappedPolicy->GetAgentId();
+            myIsAgentDelayed = myMappedPolicy->GetHeader().myIsAgentDelayed != 0;
+            myBoardSlotMapper = myMappedPolicy->GetBoardSlotMapper();
+            mySlotValues = myMappedPolicy->GetSlotValues();
+        }
+        else
+        {
+            myLoadedPolicy.reset(new TicTacToeQLearner);
+
+            if (!Utils::LoadPolicy(aPolicyPath, aFormat, *myLoadedPolicy))
+            {
+                return;
+            }
+
+            myAgentId = myLoadedPolicy->GetAgentId();
+            myIsAgentDelayed = myLoadedPolicy->GetLearningSettings().myIsAgentDelayed;
+            myBoardSlotMapper = myLoadedPolicy->GetActionValueScores().GetBoardSlotMapper();
+            mySlotValues = myLoadedPolicy->GetActionValueScores().GetSlotValues();
+        }
+    }
+
+    PolicyServer::~PolicyServer() = default;
+
+    bool PolicyServer::GetMove(const uint32_t aBoard, uint32_t& anOutCellIndex) const
+    {
+        const auto crossCellsCount = __builtin_popcount(aBoard & Utils::Detail::AllCellsMask);
+        const auto noughtCellsCount = __builtin_popcount((aBoard >> 1) & Utils::Detail::AllCellsMask);
+
+        const auto agentCellsCount = myAgentId == Player::Cross ? crossCellsCount : noughtCellsCount;
+        const auto opponentCellsCount = myAgentId == Player::Cross ? noughtCellsCount : crossCellsCount;
+
+        // The policy plays first unless it was trained delayed, whatever its side
+        const auto isAgentTurn = agentCellsCount + (myIsAgentDelayed ? 1 : 0) == opponentCellsCount;
+
+        if (!isAgentTurn || Utils::GetBoardStatus(myAgentId, aBoard) != BoardStatus::Intermediate)
+        {
+            return false;
+        }
+
+        auto bestValue = std::numeric_limits<float>::lowest();
+        auto bestMove = aBoard;
+
+        for (const auto nextMove : Utils::GenerateMoves(myAgentId, aBoard))
+        {
+            const auto nextMoveValue = mySlotValues[myBoardSlotMapper.GetSlot(nextMove)];
+
+            // Boards never met by the policy hold NaN and are skipped
+            if (nextMoveValue > bestValue)
+            {
+                bestValue = nextMoveValue;
+                bestMove = nextMove;
+            }
+        }
+
+        if (bestMove == aBoard)
+        {
+            return false;
+        }
+
+        const auto playedShift = static_cast<uint32_t>(__builtin_ctz(bestMove ^ aBoard)) & ~1u;
+        anOutCellIndex = (16 - playedShift) / 2;
+
+        return true;
+    }
+
+    bool PolicyServer::Run(const PolicyServerSettings& someSettings)
+    {
+        assert(IsValid() && "Cannot serve a policy that failed to load");
+
+        const auto isServingSocket = !someSettings.mySocketPath.empty();
+        const auto maxSessionsCount = isServingSocket ? static_cast<std::size_t>(std::max(1, someSettings.myMaxSessions)) : 1;
+
+        auto listeningDescriptor = -1;
+
+        if (isServingSocket)
+        {
+            listeningDescriptor = OpenListeningSocket(someSettings.mySocketPath, std::max(1, someSettings.myMaxSessions));
+
+            if (listeningDescriptor < 0)
+            {
+                return false;
+            }
+        }
+
+        isStopRequested = 0;
+        InstallSignalHandlers();
+
+        // Every buffer is allocated here, serving only recycles sessions
+        mySessions.assign(maxSessionsCount, Session{});
+        myPollDescriptors.resize(maxSessionsCount + 1);
+
+        std::size_t activeSessionsCount = 0;
+
+        if (!isServingSocket)
+        {
+            mySessions[0].myInputDescriptor = STDIN_FILENO;
+            mySessions[0].myOutputDescriptor = STDOUT_FILENO;
+            activeSessionsCount = 1;
+        }
+
+        const auto reportInterval = std::chrono::seconds(someSettings.myReportInterval);
+        auto lastReportTime = std::chrono::steady_clock::now();
+
+        while (!isStopRequested && (isServingSocket || activeSessionsCount > 0))
+        {
+            std::size_t pollDescriptorsCount = 0;
+
+            if (isServingSocket && activeSessionsCount < maxSessionsCount)
+            {
+                myPollDescriptors[pollDescriptorsCount++] = pollfd { listeningDescriptor, POLLIN, 0 };
+            }
+
+            for (std::size_t sessionIndex = 0; sessionIndex < activeSessionsCount; ++sessionIndex)
+            {
+                const auto& session = mySessions[sessionIndex];
+                auto& pollDescriptor = myPollDescriptors[pollDescriptorsCount++];
+
+                pollDescriptor = pollfd { session.myInputDescriptor, 0, 0 };
+
+                // Stop reading while the responses to a full input buffer could not be queued
+                if (session.myOutputEnd - session.myOutputBegin + InputBufferSize * MaxResponseSize <= OutputBufferSize)
+                {
+                    pollDescriptor.events |= POLLIN;
+                }
+
+                // Sockets are non-blocking, stdout is flushed as soon as responses are queued
+                if (session.myOutputEnd > session.myOutputBegin)
+                {
+                    pollDescriptor.events |= POLLOUT;
+                }
+            }
+
+            const auto pollTimeout = someSettings.myReportInterval > 0 ? 1000 : -1;
+
+            if (poll(myPollDescriptors.data(), pollDescriptorsCount, pollTimeout) < 0)
+            {
+                // Interrupted by a signal
+                continue;
+            }
+
+            std::size_t pollDescriptorIndex = 0;
+
+            if (isServingSocket && activeSessionsCount < maxSessionsCount)
+            {
+                const auto acceptEvents = myPollDescriptors[pollDescriptorIndex++].revents;
+
+                while ((acceptEvents & POLLIN) && activeSessionsCount < maxSessionsCount)
+                {
+                    const auto sessionDescriptor = accept4(listeningDescriptor, nullptr, nullptr, SOCK_NONBLOCK | SOCK_CLOEXEC);
+
+                    if (sessionDescriptor < 0)
+                    {
+                        break;
+                    }
+
+                    auto& session = mySessions[activeSessionsCount++];
+
+                    session.myInputDescriptor = sessionDescriptor;
+                    session.myOutputDescriptor = sessionDescriptor;
+                    session.myIsClosing = false;
+                    session.myInputSize = 0;
+                    session.myOutputBegin = 0;
+                    session.myOutputEnd = 0;
+                }
+            }
+
+            // Sessions accepted by this iteration were not polled yet
+            const auto polledSessionsCount = pollDescriptorsCount - pollDescriptorIndex;
+
+            for (std::size_t sessionIndex = 0; sessionIndex < polledSessionsCount; ++sessionIndex)
+            {
+                auto& session = mySessions[sessionIndex];
+                const auto& pollDescriptor = myPollDescriptors[pollDescriptorIndex + sessionIndex];
+                const auto sessionEvents = pollDescriptor.revents;
+
+                // Hung up sessions are only read while their responses fit in the output buffer, dropped otherwise
+                if ((sessionEvents & (POLLHUP | POLLERR)) && !(pollDescriptor.events & POLLIN))
+                {
+                    session.myIsClosing = true;
+                }
+                else if (sessionEvents & (POLLIN | POLLHUP | POLLERR))
+                {
+                    const auto readSize = read(session.myInputDescriptor, session.myInput + session.myInputSize,
+                                               InputBufferSize - session.myInputSize);
+
+                    if (readSize > 0)
+                    {
+                        session.myInputSize += static_cast<std::size_t>(readSize);
+                        ServeRequests(session);
+                    }
+                    else if (readSize == 0 || (errno != EAGAIN && errno != EINTR))
+                    {
+                        session.myIsClosing = true;
+                    }
+                }
+
+                if (session.myOutputEnd > session.myOutputBegin)
+                {
+                    FlushOutput(session);
+                }
+            }
+
+            // Closed sessions are replaced by the last active one
+            for (std::size_t sessionIndex = 0; sessionIndex < activeSessionsCount;)
+            {
+                auto& session = mySessions[sessionIndex];
+
+                if (session.myIsClosing)
+                {
+                    if (isServingSocket)
+                    {
+                        close(session.myInputDescriptor);
+                    }
+
+                    std::swap(session, mySessions[--activeSessionsCount]);
+                }
+                else
+                {
+                    ++sessionIndex;
+                }
+            }
+
+            if (someSettings.myReportInterval > 0 && std::chrono::steady_clock::now() - lastReportTime >= reportInterval)
+            {
+                ReportLatency();
+                lastReportTime = std::chrono::steady_clock::now();
+            }
+        }
+
+        for (std::size_t sessionIndex = 0; sessionIndex < activeSessionsCount && isServingSocket; ++sessionIndex)
+        {
+            close(mySessions[sessionIndex].myInputDescriptor);
+        }
+
+        if (isServingSocket)
+        {
+            close(listeningDescriptor);
+            unlink(someSettings.mySocketPath.c_str());
+        }
+
+        ReportLatency();
+
+        return true;
+    }
+
+    void PolicyServer::ServeRequests(Session& aSession)
+    {
+        std::size_t requestBegin = 0;
+
+        for (std::size_t inputIndex = 0; inputIndex < aSession.myInputSize; ++inputIndex)
+        {
+            if (aSession.myInput[inputIndex] == '\n')
+            {
+                HandleRequest(aSession.myInput + requestBegin, inputIndex - requestBegin, aSession);
+                requestBegin = inputIndex + 1;
+            }
+        }
+
+        if (requestBegin == 0 && aSession.myInputSize == InputBufferSize)
+        {
+            // No request is that long
+            aSession.myIsClosing = true;
+            return;
+        }
+
+        aSession.myInputSize -= requestBegin;
+        std::memmove(aSession.myInput, aSession.myInput + requestBegin, aSession.myInputSize);
+    }
+
+    void PolicyServer::HandleRequest(const char* aRequest, std::size_t aRequestSize, Session& aSession)
+    {
+        const auto requestStartTime = std::chrono::steady_clock::now();
+
+        uint32_t board, cellIndex;
+
+        if (aSession.myOutputEnd + MaxResponseSize > OutputBufferSize)
+        {
+            std::memmove(aSession.myOutput, aSession.myOutput + aSession.myOutputBegin, aSession.myOutputEnd - aSession.myOutputBegin);
+            aSession.myOutputEnd -= aSession.myOutputBegin;
+            aSession.myOutputBegin = 0;
+        }
+
+        // Run stops reading sessions before their output buffer fills up
+        assert(aSession.myOutputEnd + MaxResponseSize <= OutputBufferSize);
+
+        if (ParseBoard(aRequest, aRequestSize, board) && GetMove(board, cellIndex))
+        {
+            aSession.myOutput[aSession.myOutputEnd++] = static_cast<char>('0' + cellIndex);
+            aSession.myOutput[aSession.myOutputEnd++] = '\n';
+        }
+        else
+        {
+            std::memcpy(aSession.myOutput + aSession.myOutputEnd, "error\n", MaxResponseSize);
+            aSession.myOutputEnd += MaxResponseSize;
+        }
+
+        myLatencyHistogram.Record(static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(
+                std::chrono::steady_clock::now() - requestStartTime).count()));
+    }
+
+    void PolicyServer::FlushOutput(Session& aSession) const
+    {
+        while (aSession.myOutputEnd > aSession.myOutputBegin)
+        {
+            const auto writtenSize = write(aSession.myOutputDescriptor, aSession.myOutput + aSession.myOutputBegin,
+                                           aSession.myOutputEnd - aSession.myOutputBegin);
+
+            if (writtenSize < 0)
+            {
+                if (errno != EAGAIN && errno != EINTR)
+                {
+                    aSession.myIsClosing = true;
+                }
+
+                return;
+            }
+
+            aSession.myOutputBegin += static_cast<std::size_t>(writtenSize);
+        }
+
+        aSession.myOutputBegin = 0;
+        aSession.myOutputEnd = 0;
+    }
+
+    void PolicyServer::ReportLatency() const
+    {
+        std::fprintf(stderr, "requests: %llu, p50: %.2f us, p99: %.2f us, max: %.2f us\n",
+                     static_cast<unsigned long long>(myLatencyHistogram.GetCount()),
+                     myLatencyHistogram.GetQuantile(0.50) / 1000.0,
+                     myLatencyHistogram.GetQuantile(0.99) / 1000.0,
+                     myLatencyHistogram.GetMax() / 1000.0);
+    }
+}
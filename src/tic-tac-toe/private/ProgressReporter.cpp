@@ -0,0 +1,52 @@
+//
+// Created by Gianmarco Picarella on 17/10/22.
+//
+
+#include "ProgressReporter.h"
+
+namespace TTT
+{
+namespace Utils
+{
+    ProgressReporter::ProgressReporter(ReportCallback aReportCallback, std::chrono::milliseconds aReportInterval) :
+            myReportCallback(std::move(aReportCallback)),
+            myReportInterval(aReportInterval),
+            myCompletedEpisodesCount(0),
+            myIsStopping(false)
+    {
+        myReporterThread = std::thread(&ProgressReporter::ReportLoop, this);
+    }
+
+    ProgressReporter::~ProgressReporter()
+    {
+        Stop();
+    }
+
+    void ProgressReporter::Stop()
+    {
+        {
+            std::lock_guard<std::mutex> lock(myStopMutex);
+            myIsStopping = true;
+        }
+
+        myStopCondition.notify_one();
+
+        if (myReporterThread.joinable())
+        {
+            myReporterThread.join();
+        }
+    }
+
+    void ProgressReporter::ReportLoop()
+    {
+        std::unique_lock<std::mutex> lock(myStopMutex);
+
+        while (!myStopCondition.wait_for(lock, myReportInterval, [this]() { return myIsStopping; }))
+        {
+            myReportCallback(GetCompletedEpisodesCount());
+        }
+
+        myReportCallback(GetCompletedEpisodesCount());
+    }
+}
+}
@@ -0,0 +1,215 @@
+//
+// Created by Gianmarco Picarella on 17/10/22.
+//
+
+#include "ResultsStream.h"
+
+#include <algorithm>
+#include <cstring>
+
+namespace TTT
+{
+namespace Utils
+{
+    namespace
+    {
+        constexpr char StreamMagic[8] = { 'T', 'T', 'T', 'R', 'S', 'L', 'T', '1' };
+        constexpr std::size_t ReadChunkRecordsCount = 4096;
+
+        // Records are written as they are laid out in memory
+        static_assert(sizeof(ResultsStreamRecord) == 6 * sizeof(uint64_t), "Results stream records must not be padded");
+
+        std::FILE* OpenStream(const std::string& aPath)
+        {
+            auto* streamFile = std::fopen(aPath.c_str(), "rb");
+
+            if (streamFile == nullptr)
+            {
+                return nullptr;
+            }
+
+            char magic[sizeof(StreamMagic)];
+
+            if (std::fread(magic, sizeof(magic), 1, streamFile) != 1 || std::memcmp(magic, StreamMagic, sizeof(magic)) != 0)
+            {
+                std::fclose(streamFile);
+                return nullptr;
+            }
+
+            return streamFile;
+        }
+    }
+
+    ResultsStreamWriter::ResultsStreamWriter(const std::string& aPath, const float (&someRewards)[4], std::size_t aChunkRecordsCount) :
+            myFile(std::fopen(aPath.c_str(), "wb")),
+            myRewards { someRewards[0], someRewards[1], someRewards[2], someRewards[3] },
+            myIsBackChunkPending(false),
+            myIsClosing(false),
+            myHasWriteFailed(false)
+    {
+        if (myFile == nullptr)
+        {
+            return;
+        }
+
+        myHasWriteFailed = std::fwrite(StreamMagic, sizeof(StreamMagic), 1, myFile) != 1;
+
+        myFrontChunk.reserve(std::max<std::size_t>(1, aChunkRecordsCount));
+        myBackChunk.reserve(myFrontChunk.capacity());
+
+        myWriterThread = std::thread(&ResultsStreamWriter::WriteLoop, this);
+    }
+
+    ResultsStreamWriter::~ResultsStreamWriter()
+    {
+        Close();
+    }
+
+    void ResultsStreamWriter::OnEpisodesSummary(const EpisodesSummary& aSummary)
+    {
+        myTotals.myEpisodesCount += aSummary.myEpisodesCount;
+
+        for (const auto status : { BoardStatus::Win, BoardStatus::Draw, BoardStatus::Lose })
+        {
+            const auto resultsCount = aSummary.myResultsCounts[static_cast<uint32_t>(status)];
+
+            myTotals.myCumulativeReward += static_cast<double>(resultsCount) * myRewards[static_cast<uint32_t>(status)];
+            myTotals.myResultsCounts[static_cast<uint32_t>(status)] += resultsCount;
+        }
+
+        if (myFile == nullptr)
+        {
+            return;
+        }
+
+        myFrontChunk.push_back(myTotals);
+
+        if (myFrontChunk.size() < myFrontChunk.capacity())
+        {
+            return;
+        }
+
+        {
+            std::unique_lock<std::mutex> lock(myChunkMutex);
+            myChunkCondition.wait(lock, [this]() { return !myIsBackChunkPending; });
+
+            myFrontChunk.swap(myBackChunk);
+            myIsBackChunkPending = true;
+        }
+
+        myChunkCondition.notify_all();
+        myFrontChunk.clear();
+    }
+
+    bool ResultsStreamWriter::Close()
+    {
+        if (myFile == nullptr)
+        {
+            return false;
+        }
+
+        {
+            std::lock_guard<std::mutex> lock(myChunkMutex);
+            myIsClosing = true;
+        }
+
+        myChunkCondition.notify_all();
+        myWriterThread.join();
+
+        // The writer is done with the back chunk, the partial front one is written from here
+        if (!myFrontChunk.empty())
+        {
+            myHasWriteFailed |= std::fwrite(myFrontChunk.data(), sizeof(ResultsStreamRecord), myFrontChunk.size(), myFile) != myFrontChunk.size();
+            myFrontChunk.clear();
+        }
+
+        myHasWriteFailed |= std::fclose(myFile) != 0;
+        myFile = nullptr;
+
+        return !myHasWriteFailed;
+    }
+
+    void ResultsStreamWriter::WriteLoop()
+    {
+        std::unique_lock<std::mutex> lock(myChunkMutex);
+
+        while (true)
+        {
+            myChunkCondition.wait(lock, [this]() { return myIsBackChunkPending || myIsClosing; });
+
+            if (!myIsBackChunkPending)
+            {
+                return;
+            }
+
+            // The training thread only touches the back chunk once it is no longer pending
+            lock.unlock();
+
+            const auto writtenCount = std::fwrite(myBackChunk.data(), sizeof(ResultsStreamRecord), myBackChunk.size(), myFile);
+            const auto hasWriteFailed = writtenCount != myBackChunk.size();
+
+            myBackChunk.clear();
+
+            lock.lock();
+
+            myHasWriteFailed |= hasWriteFailed;
+            myIsBackChunkPending = false;
+
+            myChunkCondition.notify_all();
+        }
+    }
+
+    bool ReadResultsStream(const std::string& aPath, const std::function<void(const ResultsStreamRecord&)>& aRecordCallback)
+    {
+        auto* streamFile = OpenStream(aPath);
+
+        if (streamFile == nullptr)
+        {
+            return false;
+        }
+
+        std::vector<ResultsStreamRecord> chunk(ReadChunkRecordsCount);
+
+        for (auto readCount = std::fread(chunk.data(), sizeof(ResultsStreamRecord), chunk.size(), streamFile); readCount > 0;
+             readCount = std::fread(chunk.data(), sizeof(ResultsStreamRecord), chunk.size(), streamFile))
+        {
+            std::for_each(chunk.begin(), chunk.begin() + readCount, aRecordCallback);
+        }
+
+        std::fclose(streamFile);
+
+        return true;
+    }
+
+    bool LoadResultsStreamPoints(const std::string& aPath, std::size_t aMaxRecordsCount, std::vector<ResultsStreamRecord>& anOutRecords)
+    {
+        auto* streamFile = OpenStream(aPath);
+
+        if (streamFile == nullptr)
+        {
+            return false;
+        }
+
+        std::fseek(streamFile, 0, SEEK_END);
+        const auto recordsCount = (static_cast<std::size_t>(std::ftell(streamFile)) - sizeof(StreamMagic)) / sizeof(ResultsStreamRecord);
+        std::fclose(streamFile);
+
+        const auto maxRecordsCount = std::max<std::size_t>(1, aMaxRecordsCount);
+        const auto stride = std::max<std::size_t>(1, (recordsCount + maxRecordsCount - 1) / maxRecordsCount);
+
+        anOutRecords.clear();
+        anOutRecords.reserve((recordsCount + stride - 1) / stride);
+
+        std::size_t recordIndex = 0;
+
+        return ReadResultsStream(aPath, [&](const ResultsStreamRecord& aRecord) {
+            ++recordIndex;
+
+            if (recordIndex % stride == 0 || recordIndex == recordsCount)
+            {
+                anOutRecords.push_back(aRecord);
+            }
+        });
+    }
+}
+}
@@ -0,0 +1,121 @@
+//
+// Created by Gianmarco Picarella on 12/10/22.
+//
+
+#include "SolvedGameTable.h"
+
+#include "BoardIndexer.h"
+#include "StateGraph.h"
+
+#include <cassert>
+
+namespace TTT
+{
+    namespace
+    {
+        constexpr int8_t unsolvedValue = 2;
+
+        uint32_t GetEntryIndex(const uint32_t aBoard, const Player aPlayerToMove)
+        {
+            return 2 * Utils::GetBoardRank(aBoard) + (static_cast<uint32_t>(aPlayerToMove) - 1);
+        }
+    }
+
+    const SolvedGameTable& SolvedGameTable::GetInstance()
+    {
+        static const SolvedGameTable solvedGameTable;
+        return solvedGameTable;
+    }
+
+    SolvedGameTable::SolvedGameTable() : myEntries(2 * Utils::BoardRanksCount, Entry{ unsolvedValue, 0 })
+    {
+        const auto& stateGraph = StateGraph::GetInstance();
+
+        // Successors have larger indices, so a backward sweep solves every state after all of its successors
+        for (auto stateIndex = stateGraph.GetStatesCount(); stateIndex-- > 0;)
+        {
+            for (const auto playerToMove : { Player::Cross, Player::Nought })
+            {
+                if (stateGraph.IsReachable(stateIndex, playerToMove))
+                {
+                    Solve(stateIndex, playerToMove);
+                }
+            }
+        }
+    }
+
+    int SolvedGameTable::GetValue(const uint32_t aBoard, const Player aPlayerToMove) const
+    {
+        return GetEntry(aBoard, aPlayerToMove).myValue;
+    }
+
+    Utils::MoveList SolvedGameTable::GetOptimalMoves(const uint32_t aBoard, const Player aPlayerToMove) const
+    {
+        Utils::MoveList optimalMoves;
+
+        const auto playerId = static_cast<uint32_t>(aPlayerToMove);
+
+        for (uint32_t cells = GetEntry(aBoard, aPlayerToMove).myOptimalCellsMask; cells != 0; cells &= cells - 1)
+        {
+            const auto positionIndex = 2 * static_cast<uint32_t>(__builtin_ctz(cells));
+            optimalMoves.push_back(aBoard | (playerId << positionIndex));
+        }
+
+        return optimalMoves;
+    }
+
+    const SolvedGameTable::Entry& SolvedGameTable::GetEntry(const uint32_t aBoard, const Player aPlayerToMove) const
+    {
+        const auto& entry = myEntries[GetEntryIndex(aBoard, aPlayerToMove)];
+
+        assert(entry.myValue != unsolvedValue && "Board not reachable from the empty board");
+
+        return entry;
+    }
+
+    void SolvedGameTable::Solve(const uint32_t aStateIndex, const Player aPlayerToMove)
+    {
+        const auto& stateGraph = StateGraph::GetInstance();
+        const auto board = stateGraph.GetBoard(aStateIndex);
+
+        auto& entry = myEntries[GetEntryIndex(board, aPlayerToMove)];
+
+        switch (stateGraph.GetStatus(aStateIndex, aPlayerToMove))
+        {
+            case BoardStatus::Win: entry.myValue = 1; return;
+            case BoardStatus::Draw: entry.myValue = 0; return;
+            case BoardStatus::Lose: entry.myValue = -1; return;
+            default: break;
+        }
+
+        const auto nextPlayer = static_cast<Player>((~static_cast<uint32_t>(aPlayerToMove)) & 0x3);
+
+        auto bestValue = -1;
+        uint16_t bestCellsMask = 0;
+
+        for (const auto nextStateIndex : stateGraph.GetSuccessors(aStateIndex, aPlayerToMove))
+        {
+            const auto nextBoard = stateGraph.GetBoard(nextStateIndex);
+            const auto& nextEntry = myEntries[GetEntryIndex(nextBoard, nextPlayer)];
+
+            assert(nextEntry.myValue != unsolvedValue && "Successors must be solved first");
+
+            const auto moveValue = -nextEntry.myValue;
+            const auto positionIndex = static_cast<uint32_t>(__builtin_ctz(nextBoard ^ board));
+            const auto cellMask = static_cast<uint16_t>(1u << (positionIndex / 2));
+
+            if (moveValue > bestValue || bestCellsMask == 0)
+            {
+                bestValue = moveValue;
+                bestCellsMask = cellMask;
+            }
+            else if (moveValue == bestValue)
+            {
+                bestCellsMask |= cellMask;
+            }
+        }
+
+        entry.myValue = static_cast<int8_t>(bestValue);
+        entry.myOptimalCellsMask = bestCellsMask;
+    }
+}
@@ -0,0 +1,150 @@
+//
+// Created by Gianmarco Picarella on 17/10/22.
+//
+
+#include "StateGraph.h"
+
+#include "GameUtils.h"
+
+#include <algorithm>
+#include <cassert>
+#include <utility>
+
+namespace TTT
+{
+    namespace
+    {
+        uint32_t GetPiecesCount(const uint32_t aBoard)
+        {
+            return static_cast<uint32_t>(__builtin_popcount((aBoard | (aBoard >> 1)) & 0x15555));
+        }
+
+        Player GetOtherPlayer(const Player aPlayer)
+        {
+            return static_cast<Player>((~static_cast<uint32_t>(aPlayer)) & 0x3);
+        }
+
+        // Bit of the move results masks for a moving and a starting player
+        uint8_t GetMoveResultBit(const Player aMovingPlayer, const Player aStartingPlayer)
+        {
+            return static_cast<uint8_t>(1u << (2 * (static_cast<uint32_t>(aMovingPlayer) - 1) + (static_cast<uint32_t>(aStartingPlayer) - 1)));
+        }
+    }
+
+    constexpr uint32_t StateGraph::InvalidStateIndex;
+
+    const StateGraph& StateGraph::GetInstance()
+    {
+        static const StateGraph stateGraph;
+        return stateGraph;
+    }
+
+    StateGraph::StateGraph() : myStateIndices(Utils::BoardRanksCount, InvalidStateIndex)
+    {
+        constexpr auto startingBoard = 0x00000000u;
+
+        // Indexed by board rank
+        std::vector<uint8_t> playersToMoveMasks(Utils::BoardRanksCount, 0);
+        std::vector<uint8_t> moveResultsMasks(Utils::BoardRanksCount, 0);
+
+        std::vector<uint32_t> reachedBoards;
+        std::vector<std::pair<uint32_t, Player>> pendingStates;
+
+        // Depth-first walk of the games of each starting player, (board, player to move) pairs are expanded once
+        for (const auto startingPlayer : { Player::Cross, Player::Nought })
+        {
+            std::vector<uint8_t> expandedPlayersMasks(Utils::BoardRanksCount, 0);
+
+            pendingStates.emplace_back(startingBoard, startingPlayer);
+
+            while (!pendingStates.empty())
+            {
+                const auto board = pendingStates.back().first;
+                const auto playerToMove = pendingStates.back().second;
+                const auto rank = Utils::GetBoardRank(board);
+
+                pendingStates.pop_back();
+
+                if ((expandedPlayersMasks[rank] & static_cast<uint8_t>(playerToMove)) != 0)
+                {
+                    continue;
+                }
+
+                expandedPlayersMasks[rank] |= static_cast<uint8_t>(playerToMove);
+
+                if (playersToMoveMasks[rank] == 0)
+                {
+                    reachedBoards.push_back(board);
+                }
+
+                playersToMoveMasks[rank] |= static_cast<uint8_t>(playerToMove);
+
+                if (Utils::GetBoardStatus(playerToMove, board) != BoardStatus::Intermediate)
+                {
+                    continue;
+                }
+
+                for (const auto nextBoard : Utils::GenerateMoves(playerToMove, board))
+                {
+                    moveResultsMasks[Utils::GetBoardRank(nextBoard)] |= GetMoveResultBit(playerToMove, startingPlayer);
+                    pendingStates.emplace_back(nextBoard, GetOtherPlayer(playerToMove));
+                }
+            }
+        }
+
+        std::sort(reachedBoards.begin(), reachedBoards.end(), [](const uint32_t aBoard, const uint32_t anOtherBoard) {
+            const auto piecesCount = GetPiecesCount(aBoard);
+            const auto otherPiecesCount = GetPiecesCount(anOtherBoard);
+
+            return piecesCount != otherPiecesCount ? piecesCount < otherPiecesCount :
+                   Utils::GetBoardRank(aBoard) < Utils::GetBoardRank(anOtherBoard);
+        });
+
+        myBoards = std::move(reachedBoards);
+        myCrossStatuses.reserve(myBoards.size());
+        myPlayersToMoveMasks.reserve(myBoards.size());
+
+        for (uint32_t stateIndex = 0; stateIndex < myBoards.size(); ++stateIndex)
+        {
+            const auto board = myBoards[stateIndex];
+            const auto rank = Utils::GetBoardRank(board);
+
+            myStateIndices[rank] = stateIndex;
+            myCrossStatuses.push_back(static_cast<uint8_t>(Utils::GetBoardStatus(Player::Cross, board)));
+            myPlayersToMoveMasks.push_back(playersToMoveMasks[rank]);
+
+            for (const auto movingPlayer : { Player::Cross, Player::Nought })
+            {
+                for (const auto startingPlayer : { Player::Cross, Player::Nought })
+                {
+                    if ((moveResultsMasks[rank] & GetMoveResultBit(movingPlayer, startingPlayer)) != 0)
+                    {
+                        myMoveResults[static_cast<uint32_t>(movingPlayer) - 1][static_cast<uint32_t>(startingPlayer) - 1].push_back(stateIndex);
+                    }
+                }
+            }
+        }
+
+        for (const auto playerToMove : { Player::Cross, Player::Nought })
+        {
+            auto& rows = myMoveRows[static_cast<uint32_t>(playerToMove) - 1];
+
+            rows.myOffsets.reserve(myBoards.size() + 1);
+            rows.myOffsets.push_back(0);
+
+            for (uint32_t stateIndex = 0; stateIndex < myBoards.size(); ++stateIndex)
+            {
+                if (IsReachable(stateIndex, playerToMove) && !IsTerminal(stateIndex))
+                {
+                    for (const auto nextBoard : Utils::GenerateMoves(playerToMove, myBoards[stateIndex]))
+                    {
+                        assert(GetStateIndex(nextBoard) > stateIndex && "Successors must follow their predecessors");
+                        rows.mySuccessors.push_back(GetStateIndex(nextBoard));
+                    }
+                }
+
+                rows.myOffsets.push_back(static_cast<uint32_t>(rows.mySuccessors.size()));
+            }
+        }
+    }
+}
@@ -0,0 +1,175 @@
+//
+// Created by Gianmarco Picarella on 17/10/22.
+//
+
+#include "TrainingMetrics.h"
+
+#include <algorithm>
+#include <cstdio>
+#include <fstream>
+
+namespace TTT
+{
+    TrainingMetrics::TrainingMetrics(std::size_t aWindowSize, double aSnapshotInterval) :
+            myEpisodesCount(0),
+            myMovesCount(0),
+            myResultsWindow(std::max<std::size_t>(1, aWindowSize), BoardStatus::Intermediate),
+            myResultsWindowIndex(0),
+            myResultsCounts{ 0, 0, 0, 0 },
+            myStartTime(std::chrono::steady_clock::now()),
+            mySnapshotInterval(std::chrono::duration_cast<std::chrono::steady_clock::duration>(std::chrono::duration<double>(aSnapshotInterval))),
+            myNextSnapshotTime(myStartTime + mySnapshotInterval),
+            myLastSnapshotTime(myStartTime),
+            myLastEpisodesCount(0),
+            myLastMovesCount(0),
+            myDumpFormat(MetricsFormat::JsonLines),
+            myFailedDumpsCount(0)
+    {
+    }
+
+    bool TrainingMetrics::SetDumpFile(const std::string& aPath, const MetricsFormat aFormat)
+    {
+        myDumpPath.clear();
+
+        // Every JSON lines run starts a new series, Prometheus files are written next to their path first
+        const auto checkedPath = aFormat == MetricsFormat::JsonLines ? aPath : aPath + ".tmp";
+        std::ofstream dumpStream(checkedPath, std::ios::trunc);
+
+        if (!dumpStream.is_open())
+        {
+            return false;
+        }
+
+        if (aFormat == MetricsFormat::Prometheus)
+        {
+            dumpStream.close();
+            std::remove(checkedPath.c_str());
+        }
+
+        myDumpPath = aPath;
+        myDumpFormat = aFormat;
+
+        return true;
+    }
+
+    void TrainingMetrics::TakeSnapshot(const RL::LearnerStatistics& someLearnerStatistics, float aRandomEpsilon)
+    {
+        const auto snapshotTime = std::chrono::steady_clock::now();
+        const auto sinceLastSnapshot = std::chrono::duration<double>(snapshotTime - myLastSnapshotTime).count();
+
+        TrainingMetricsSnapshot snapshot;
+
+        snapshot.myEpisodesCount = myEpisodesCount;
+        snapshot.myMovesCount = myMovesCount;
+        snapshot.myElapsedSeconds = std::chrono::duration<double>(snapshotTime - myStartTime).count();
+
+        if (sinceLastSnapshot > 0.0)
+        {
+            snapshot.myEpisodesPerSecond = (myEpisodesCount - myLastEpisodesCount) / sinceLastSnapshot;
+            snapshot.myMovesPerSecond = (myMovesCount - myLastMovesCount) / sinceLastSnapshot;
+        }
+
+        const auto explorationActionsCount = someLearnerStatistics.myExplorationActionsCount - myLastLearnerStatistics.myExplorationActionsCount;
+        const auto actionsCount = explorationActionsCount + someLearnerStatistics.myGreedyActionsCount - myLastLearnerStatistics.myGreedyActionsCount;
+        const auto valueUpdatesCount = someLearnerStatistics.myValueUpdatesCount - myLastLearnerStatistics.myValueUpdatesCount;
+
+        snapshot.myExplorationRatio = actionsCount > 0 ? static_cast<double>(explorationActionsCount) / actionsCount : 0.0;
+        snapshot.myRandomEpsilon = aRandomEpsilon;
+        snapshot.myMeanValueUpdateMagnitude = valueUpdatesCount > 0 ?
+                (someLearnerStatistics.myValueUpdatesMagnitudeSum - myLastLearnerStatistics.myValueUpdatesMagnitudeSum) / valueUpdatesCount : 0.0;
+
+        const auto windowEpisodesCount = std::min<uint64_t>(myEpisodesCount, myResultsWindow.size());
+
+        if (windowEpisodesCount > 0)
+        {
+            snapshot.myWinRate = static_cast<double>(myResultsCounts[static_cast<uint32_t>(BoardStatus::Win)]) / windowEpisodesCount;
+            snapshot.myDrawRate = static_cast<double>(myResultsCounts[static_cast<uint32_t>(BoardStatus::Draw)]) / windowEpisodesCount;
+            snapshot.myLoseRate = static_cast<double>(myResultsCounts[static_cast<uint32_t>(BoardStatus::Lose)]) / windowEpisodesCount;
+        }
+
+        myLastSnapshotTime = snapshotTime;
+        myNextSnapshotTime = snapshotTime + mySnapshotInterval;
+        myLastEpisodesCount = myEpisodesCount;
+        myLastMovesCount = myMovesCount;
+        myLastLearnerStatistics = someLearnerStatistics;
+
+        {
+            std::lock_guard<std::mutex> lock(mySnapshotMutex);
+            mySnapshot = snapshot;
+        }
+
+        if (!myDumpPath.empty() && !DumpSnapshot(snapshot))
+        {
+            ++myFailedDumpsCount;
+        }
+    }
+
+    TrainingMetricsSnapshot TrainingMetrics::GetSnapshot() const
+    {
+        std::lock_guard<std::mutex> lock(mySnapshotMutex);
+        return mySnapshot;
+    }
+
+    bool TrainingMetrics::DumpSnapshot(const TrainingMetricsSnapshot& aSnapshot) const
+    {
+        if (myDumpFormat == MetricsFormat::JsonLines)
+        {
+            auto* dumpFile = std::fopen(myDumpPath.c_str(), "a");
+
+            if (dumpFile == nullptr)
+            {
+                return false;
+            }
+
+            std::fprintf(dumpFile,
+                         "{\"elapsed_seconds\": %.3f, \"episodes\": %llu, \"moves\": %llu, \"episodes_per_second\": %.1f, "
+                         "\"moves_per_second\": %.1f, \"exploration_ratio\": %.4f, \"random_epsilon\": %.6f, "
+                         "\"mean_value_update_magnitude\": %.6f, \"win_rate\": %.4f, \"draw_rate\": %.4f, \"lose_rate\": %.4f}\n",
+                         aSnapshot.myElapsedSeconds,
+                         static_cast<unsigned long long>(aSnapshot.myEpisodesCount),
+                         static_cast<unsigned long long>(aSnapshot.myMovesCount),
+                         aSnapshot.myEpisodesPerSecond, aSnapshot.myMovesPerSecond,
+                         aSnapshot.myExplorationRatio, aSnapshot.myRandomEpsilon, aSnapshot.myMeanValueUpdateMagnitude,
+                         aSnapshot.myWinRate, aSnapshot.myDrawRate, aSnapshot.myLoseRate);
+
+            return std::fclose(dumpFile) == 0;
+        }
+
+        // Scrapers never see a partially written file
+        const auto temporaryPath = myDumpPath + ".tmp";
+
+        auto* dumpFile = std::fopen(temporaryPath.c_str(), "w");
+
+        if (dumpFile == nullptr)
+        {
+            return false;
+        }
+
+        std::fprintf(dumpFile,
+                     "# TYPE tictactoe_episodes_total counter\ntictactoe_episodes_total %llu\n"
+                     "# TYPE tictactoe_moves_total counter\ntictactoe_moves_total %llu\n"
+                     "# TYPE tictactoe_episodes_per_second gauge\ntictactoe_episodes_per_second %.1f\n"
+                     "# TYPE tictactoe_moves_per_second gauge\ntictactoe_moves_per_second %.1f\n"
+                     "# TYPE tictactoe_exploration_ratio gauge\ntictactoe_exploration_ratio %.4f\n"
+                     "# TYPE tictactoe_random_epsilon gauge\ntictactoe_random_epsilon %.6f\n"
+                     "# TYPE tictactoe_mean_value_update_magnitude gauge\ntictactoe_mean_value_update_magnitude %.6f\n"
+                     "# TYPE tictactoe_result_rate gauge\n"
+                     "tictactoe_result_rate{result=\"win\"} %.4f\n"
+                     "tictactoe_result_rate{result=\"draw\"} %.4f\n"
+                     "tictactoe_result_rate{result=\"lose\"} %.4f\n",
+                     static_cast<unsigned long long>(aSnapshot.myEpisodesCount),
+                     static_cast<unsigned long long>(aSnapshot.myMovesCount),
+                     aSnapshot.myEpisodesPerSecond, aSnapshot.myMovesPerSecond,
+                     aSnapshot.myExplorationRatio, aSnapshot.myRandomEpsilon, aSnapshot.myMeanValueUpdateMagnitude,
+                     aSnapshot.myWinRate, aSnapshot.myDrawRate, aSnapshot.myLoseRate);
+
+        // The previous snapshot stays in place if this one could not be written
+        if (std::fclose(dumpFile) != 0)
+        {
+            std::remove(temporaryPath.c_str());
+            return false;
+        }
+
+        return std::rename(temporaryPath.c_str(), myDumpPath.c_str()) == 0;
+    }
+}
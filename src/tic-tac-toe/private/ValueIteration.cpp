@@ -0,0 +1,131 @@
+//
+// Created by Gianmarco Picarella on 17/10/22.
+//
+
+#include "ValueIteration.h"
+
+#include "BoardIndexedStorage.h"
+#include "GameUtils.h"
+#include "QLearnerJobs.h"
+#include "SolvedGameTable.h"
+#include "StateGraph.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <limits>
+#include <vector>
+
+namespace TTT
+{
+namespace Utils
+{
+    TicTacToeQLearner SolveActionValues(const Player anAgentId, const TicTacToeSettings<BoardStatus>& someLearningSettings,
+                                        const ValueIterationSettings& someValueIterationSettings,
+                                        ValueIterationResult* anOutResult)
+    {
+        const auto& stateGraph = StateGraph::GetInstance();
+
+        const auto otherPlayer = static_cast<Player>((~static_cast<uint32_t>(anAgentId)) & 0x3);
+        const auto startingPlayer = someLearningSettings.myIsAgentDelayed ? otherPlayer : anAgentId;
+        const auto opponentRandomEpsilon = someValueIterationSettings.myOpponentRandomEpsilon;
+        const auto gamma = someLearningSettings.myGamma;
+
+        const auto getStaticScore = [&](const uint32_t aStateIndex) {
+            return GetStaticScore(someLearningSettings, stateGraph.GetStatus(aStateIndex, anAgentId));
+        };
+
+        const auto* solvedGameTable = opponentRandomEpsilon < 1.f ? &SolvedGameTable::GetInstance() : nullptr;
+
+        // States the agent can move to, by increasing index
+        const auto& agentStates = stateGraph.GetMoveResults(anAgentId, startingPlayer);
+
+        // Indexed by state, only the agent states are used
+        std::vector<float> values(stateGraph.GetStatesCount(), 0.f);
+
+        for (const auto stateIndex : agentStates)
+        {
+            values[stateIndex] = getStaticScore(stateIndex);
+        }
+
+        // In place (Gauss-Seidel) sweeps of the Bellman optimality backup of QLearnerPolicy::Update
+        ValueIterationResult result;
+
+        do
+        {
+            result.myMaxValueChange = 0.f;
+
+            // Fuller boards first, so that every successor is updated before the boards leading to it
+            for (auto agentStateIt = agentStates.rbegin(); agentStateIt != agentStates.rend(); ++agentStateIt)
+            {
+                const auto stateIndex = *agentStateIt;
+
+                // Finished boards keep the static score of their status
+                if (stateGraph.IsTerminal(stateIndex))
+                {
+                    continue;
+                }
+
+                const auto opponentStates = stateGraph.GetSuccessors(stateIndex, otherPlayer);
+                const auto optimalMoves = solvedGameTable != nullptr ?
+                                          solvedGameTable->GetOptimalMoves(stateGraph.GetBoard(stateIndex), otherPlayer) : MoveList{};
+
+                auto value = 0.f;
+
+                for (const auto opponentStateIndex : opponentStates)
+                {
+                    auto probability = opponentRandomEpsilon / opponentStates.size();
+
+                    if (std::find(optimalMoves.begin(), optimalMoves.end(), stateGraph.GetBoard(opponentStateIndex)) != optimalMoves.end())
+                    {
+                        probability += (1.f - opponentRandomEpsilon) / optimalMoves.size();
+                    }
+
+                    if (probability <= 0.f)
+                    {
+                        continue;
+                    }
+
+                    if (stateGraph.IsTerminal(opponentStateIndex))
+                    {
+                        value += probability * getStaticScore(opponentStateIndex);
+                        continue;
+                    }
+
+                    auto maxValue = std::numeric_limits<float>::lowest();
+
+                    for (const auto nextStateIndex : stateGraph.GetSuccessors(opponentStateIndex, anAgentId))
+                    {
+                        maxValue = std::max(maxValue, values[nextStateIndex]);
+                    }
+
+                    value += probability * gamma * maxValue;
+                }
+
+                result.myMaxValueChange = std::max(result.myMaxValueChange, std::fabs(value - values[stateIndex]));
+                values[stateIndex] = value;
+            }
+
+            ++result.mySweepsCount;
+        }
+        while (result.myMaxValueChange > someValueIterationSettings.myTolerance &&
+               result.mySweepsCount < someValueIterationSettings.myMaxSweepsCount);
+
+        if (anOutResult != nullptr)
+        {
+            *anOutResult = result;
+        }
+
+        BoardIndexedStorage actionValueScores;
+        actionValueScores.SetBoardMapping(someLearningSettings.myUseSymmetries,
+                                          someLearningSettings.myShareSidesTable && anAgentId == Player::Nought);
+
+        for (const auto stateIndex : agentStates)
+        {
+            actionValueScores.Set(stateGraph.GetBoard(stateIndex), values[stateIndex]);
+        }
+
+        return TicTacToeQLearner { anAgentId, someLearningSettings, actionValueScores.GetBoardSlotMapper(), actionValueScores.GetSlotValues() };
+    }
+}
+}
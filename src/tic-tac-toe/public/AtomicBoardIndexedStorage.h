@@ -0,0 +1,171 @@
+//
+// Created by Gianmarco Picarella on 14/10/22.
+//
+
+#ifndef RLEXPERIMENTS_ATOMICBOARDINDEXEDSTORAGE_H
+#define RLEXPERIMENTS_ATOMICBOARDINDEXEDSTORAGE_H
+
+#include <cereal/cereal.hpp>
+#include <cereal/types/unordered_map.hpp>
+#include <SerializationUtils.h>
+
+#include <atomic>
+#include <cassert>
+#include <cmath>
+#include <limits>
+#include <memory>
+#include <unordered_map>
+#include <vector>
+
+#include "BoardIndexer.h"
+
+namespace TTT
+{
+    // Lock-free variant of BoardIndexedStorage for Hogwild-style training.
+    // Copies share the same table, so learners copied from a common one update it concurrently without locks.
+    // Every slot is a relaxed atomic float padded to its own cache line, Add is a compare-and-swap loop.
+    // The key set is fixed: values must be inserted before the table is shared between threads.
+    class AtomicBoardIndexedStorage
+    {
+    public:
+        // Copies share the same table
+        static constexpr bool IsSharedBetweenCopies = true;
+
+        AtomicBoardIndexedStorage() : mySlots(MakeSlots(Utils::BoardRanksCount)) {}
+
+        // Must be called before inserting any value and before copying the storage, the table is allocated again
+        void SetBoardMapping(const bool aSymmetryReducedFlag, const bool aColourSwappedFlag)
+        {
+            myBoardSlotMapper.SetMapping(aSymmetryReducedFlag, aColourSwappedFlag);
+            mySlots = MakeSlots(myBoardSlotMapper.GetSlotsCount());
+        }
+
+        const Utils::BoardSlotMapper& GetBoardSlotMapper() const { return myBoardSlotMapper; }
+
+        bool Contains(const uint32_t& aBoard) const
+        {
+            return !std::isnan(GetSlot(aBoard).load(std::memory_order_relaxed));
+        }
+
+        float Get(const uint32_t& aBoard) const
+        {
+            assert(Contains(aBoard));
+            return GetSlot(aBoard).load(std::memory_order_relaxed);
+        }
+
+        void Set(const uint32_t& aBoard, float aValue)
+        {
+            GetSlot(aBoard).store(aValue, std::memory_order_relaxed);
+        }
+
+        void Add(const uint32_t& aBoard, float aDelta)
+        {
+            assert(Contains(aBoard));
+
+            auto& slotValue = GetSlot(aBoard);
+            auto currentValue = slotValue.load(std::memory_order_relaxed);
+
+            while (!slotValue.compare_exchange_weak(currentValue, currentValue + aDelta, std::memory_order_relaxed)) {}
+        }
+
+        // Bulk copy of the values laid out by a storage with the same board mapping
+        void SetSlotValues(const float* someSlotValues)
+        {
+            for (uint32_t slot = 0; slot < mySlots->size(); ++slot)
+            {
+                (*mySlots)[slot].myValue.store(someSlotValues[slot], std::memory_order_relaxed);
+            }
+        }
+
+        // Storages sharing this table are already merged, otherwise every slot becomes the mean of the others
+        void SetToAverageOf(const std::vector<const AtomicBoardIndexedStorage*>& someStorages)
+        {
+            assert(!someStorages.empty());
+
+            for (uint32_t slot = 0; slot < mySlots->size(); ++slot)
+            {
+                auto valuesSum = 0.f;
+
+                for (const auto* storage : someStorages)
+                {
+                    assert(storage->myBoardSlotMapper == myBoardSlotMapper);
+                    valuesSum += (*storage->mySlots)[slot].myValue.load(std::memory_order_relaxed);
+                }
+
+                (*mySlots)[slot].myValue.store(valuesSum / someStorages.size(), std::memory_order_relaxed);
+            }
+        }
+
+        template<class Archive>
+        void save(Archive & archive) const
+        {
+            std::unordered_map<uint32_t, float> boardValues;
+
+            for (uint32_t slot = 0; slot < mySlots->size(); ++slot)
+            {
+                const auto value = (*mySlots)[slot].myValue.load(std::memory_order_relaxed);
+
+                if (!std::isnan(value))
+                {
+                    boardValues.insert(std::make_pair(myBoardSlotMapper.GetBoard(slot), value));
+                }
+            }
+
+            archive(CEREAL_NVP(myBoardSlotMapper), CEREAL_NVP(boardValues));
+        }
+
+        template<class Archive>
+        void load(Archive & archive)
+        {
+            std::unordered_map<uint32_t, float> boardValues;
+
+            // Policies saved before the board indexed storages hold the map of every board value in place of this node
+            if (RL::IsNextNode(archive, "myBoardSlotMapper"))
+            {
+                archive(CEREAL_NVP(myBoardSlotMapper), CEREAL_NVP(boardValues));
+            }
+            else
+            {
+                myBoardSlotMapper.SetMapping(false, false);
+                cereal::load(archive, boardValues);
+            }
+
+            mySlots = MakeSlots(myBoardSlotMapper.GetSlotsCount());
+
+            for (const auto& boardValue : boardValues)
+            {
+                Set(boardValue.first, boardValue.second);
+            }
+        }
+
+    private:
+        // Keeps every value on its own cache line so that hot boards do not false-share
+        struct Slot
+        {
+            std::atomic<float> myValue;
+            char myPadding[64 - sizeof(std::atomic<float>)];
+        };
+
+        static std::shared_ptr<std::vector<Slot>> MakeSlots(const uint32_t aSlotsCount)
+        {
+            auto slots = std::make_shared<std::vector<Slot>>(aSlotsCount);
+
+            for (auto& slot : *slots)
+            {
+                slot.myValue.store(std::numeric_limits<float>::quiet_NaN(), std::memory_order_relaxed);
+            }
+
+            return slots;
+        }
+
+        std::atomic<float>& GetSlot(const uint32_t aBoard) const
+        {
+            return (*mySlots)[myBoardSlotMapper.GetSlot(aBoard)].myValue;
+        }
+
+        std::shared_ptr<std::vector<Slot>> mySlots;
+        Utils::BoardSlotMapper myBoardSlotMapper;
+    };
+}
+
+#endif //RLEXPERIMENTS_ATOMICBOARDINDEXEDSTORAGE_H
@@ -0,0 +1,164 @@
+//
+// Created by Gianmarco Picarella on 15/10/22.
+//
+
+#ifndef RLEXPERIMENTS_BATCHEDENVIRONMENT_H
+#define RLEXPERIMENTS_BATCHEDENVIRONMENT_H
+
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <vector>
+
+#include "GameUtils.h"
+#include "RandomOpponent.h"
+
+namespace TTT
+{
+    // Tic-tac-toe environment stepping a batch of games in lockstep.
+    // Boards and statuses are kept as structure of arrays: board status detection runs over
+    // eight games at once with AVX2 (scalar fallback otherwise) and moves are only asked for
+    // the games that are still running. Since every game starts from the empty board with the same
+    // player, all the running games have the same player to move at every ply.
+    // Learners are updated once the whole batch is over, so they play a batch with the values of the previous one.
+    class BatchedEnvironment
+    {
+    public:
+        explicit BatchedEnvironment(std::size_t aBatchSize);
+
+        std::size_t GetBatchSize() const { return myBatchSize; }
+
+        // Plays aGamesCount (at most the batch size) full games, then hands every finished trajectory
+        // to the callback, called as onEpisodeEndCallback(trajectory, gameIndex), and to the learner update
+        template <typename LearningAgent, typename TrainerAgent, typename EpisodeCallback>
+        void Run(LearningAgent& aLearningAgent,
+                 TrainerAgent& aTrainerAgent,
+                 std::size_t aGamesCount,
+                 bool aFirstMoveFromLearnerFlag,
+                 EpisodeCallback&& onEpisodeEndCallback)
+        {
+            Reset(aGamesCount);
+
+            const auto learnerId = aLearningAgent.GetAgentId();
+            auto player = aFirstMoveFromLearnerFlag ? learnerId : aTrainerAgent.GetAgentId();
+
+            for (uint32_t ply = 0; ply < MaxEpisodeLength; ++ply)
+            {
+                if (player == learnerId)
+                {
+                    SelectMoves(aLearningAgent, ply);
+                }
+                else
+                {
+                    SelectMoves(aTrainerAgent, ply);
+                }
+
+                UpdateStatuses(learnerId);
+
+                player = static_cast<TTT::Player>((~static_cast<uint32_t>(player)) & 0x3);
+            }
+
+            const auto isTraining = aLearningAgent.GetLearningSettings().myIsTraining;
+
+            for (std::size_t gameIndex = 0; gameIndex < myGamesCount; ++gameIndex)
+            {
+                const auto historyBegin = myHistories.begin() + gameIndex * MaxEpisodeLength;
+                myEpisode.assign(historyBegin, historyBegin + myEpisodeLengths[gameIndex]);
+
+                onEpisodeEndCallback(myEpisode, gameIndex);
+
+                if (isTraining)
+                {
+                    aLearningAgent.Update(myEpisode);
+                }
+            }
+        }
+
+    private:
+        static constexpr uint32_t MaxEpisodeLength = 9;
+
+        void Reset(std::size_t aGamesCount);
+
+        // Recomputes the status of every game from the learner point of view.
+        // Finished games keep their board, hence their status.
+        void UpdateStatuses(const Player aLearnerPlayer);
+
+        template <typename Agent>
+        void SelectMoves(Agent& anAgent, uint32_t aPly)
+        {
+            for (std::size_t gameIndex = 0; gameIndex < myGamesCount; ++gameIndex)
+            {
+                if (myStatuses[gameIndex] == static_cast<uint32_t>(BoardStatus::Intermediate))
+                {
+                    myBoards[gameIndex] = anAgent.GetNextAction(myBoards[gameIndex]);
+                    RecordMove(gameIndex, aPly);
+                }
+            }
+        }
+
+        // Uniform random moves are drawn directly from the empty cells masks with the opponent's generator
+        void SelectMoves(RandomOpponent& aRandomOpponent, uint32_t aPly);
+
+        void RecordMove(std::size_t aGameIndex, uint32_t aPly)
+        {
+            myHistories[aGameIndex * MaxEpisodeLength + aPly] = myBoards[aGameIndex];
+            myEpisodeLengths[aGameIndex] = aPly + 1;
+        }
+
+        std::size_t myBatchSize;
+        std::size_t myGamesCount;
+
+        std::vector<uint32_t> myBoards;
+        std::vector<uint32_t> myStatuses;
+        std::vector<uint32_t> myHistories;
+        std::vector<uint32_t> myEpisodeLengths;
+        std::vector<uint32_t> myEpisode;
+    };
+
+namespace Utils
+{
+// Same as Simulate, but the episodes are played in lockstep batches by a BatchedEnvironment
+template <typename LearningAgent, typename TrainerAgent, typename EpisodeObserver = NullEpisodeObserver>
+void BatchedSimulate(LearningAgent& aLearningAgent,
+                     TrainerAgent& aTrainerAgent,
+                     int anIterationsCount,
+                     std::size_t aBatchSize,
+                     bool aFirstMoveFromLearnerFlag = true,
+                     EpisodeObserver&& anEpisodeObserver = EpisodeObserver{},
+                     TrainingMetrics* someTrainingMetrics = nullptr)
+{
+    assert(!aLearningAgent.IsUpdatingOnline() && "Batched games interleave the learner moves, online updates need whole episodes");
+
+    BatchedEnvironment batchedEnvironment(aBatchSize);
+
+    for (auto firstEpisodeIdx = 0; firstEpisodeIdx < anIterationsCount; firstEpisodeIdx += static_cast<int>(aBatchSize))
+    {
+        const auto gamesCount = std::min(aBatchSize, static_cast<std::size_t>(anIterationsCount - firstEpisodeIdx));
+
+        batchedEnvironment.Run(aLearningAgent, aTrainerAgent, gamesCount, aFirstMoveFromLearnerFlag,
+                               [&](const std::vector<uint32_t>& aGameplayHistory, std::size_t aGameIndex) {
+            anEpisodeObserver.OnEpisodeEnd(aGameplayHistory, firstEpisodeIdx + static_cast<int>(aGameIndex));
+
+            // Learner statistics lag one batch behind, since the learner is updated once the batch is over
+            if (someTrainingMetrics != nullptr)
+            {
+                someTrainingMetrics->RecordEpisode(aGameplayHistory.size(),
+                                                   GetBoardStatus(aLearningAgent.GetAgentId(), aGameplayHistory.back()),
+                                                   aLearningAgent.GetStatistics(),
+                                                   Detail::GetRandomEpsilon(aLearningAgent.GetLearningSettings(), 0));
+            }
+        });
+    }
+
+    anEpisodeObserver.OnSimulationEnd();
+
+    if (someTrainingMetrics != nullptr)
+    {
+        someTrainingMetrics->TakeSnapshot(aLearningAgent.GetStatistics(),
+                                          Detail::GetRandomEpsilon(aLearningAgent.GetLearningSettings(), 0));
+    }
+}
+}
+}
+
+#endif //RLEXPERIMENTS_BATCHEDENVIRONMENT_H
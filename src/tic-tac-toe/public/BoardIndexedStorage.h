@@ -0,0 +1,141 @@
+//
+// Created by Gianmarco Picarella on 10/10/22.
+//
+
+#ifndef RLEXPERIMENTS_BOARDINDEXEDSTORAGE_H
+#define RLEXPERIMENTS_BOARDINDEXEDSTORAGE_H
+
+#include <cereal/cereal.hpp>
+#include <cereal/types/unordered_map.hpp>
+#include <SerializationUtils.h>
+
+#include <algorithm>
+#include <cassert>
+#include <cmath>
+#include <limits>
+#include <unordered_map>
+#include <vector>
+
+#include "BoardIndexer.h"
+
+namespace TTT
+{
+    // Dense action-value storage for Tic-tac-toe boards.
+    // Every board owns one slot of a contiguous float array addressed by its base-3 rank,
+    // slots of boards that were never inserted hold NaN.
+    // Boards can optionally be reduced to their canonical symmetric board and/or colour swapped
+    // before being addressed, so that equivalent boards share the same slot; reduced tables only hold the canonical slots.
+    class BoardIndexedStorage
+    {
+    public:
+        // Copies own an independent table
+        static constexpr bool IsSharedBetweenCopies = false;
+
+        BoardIndexedStorage() : myValues(Utils::BoardRanksCount, std::numeric_limits<float>::quiet_NaN()) {}
+
+        // Must be called before inserting any value
+        void SetBoardMapping(const bool aSymmetryReducedFlag, const bool aColourSwappedFlag)
+        {
+            myBoardSlotMapper.SetMapping(aSymmetryReducedFlag, aColourSwappedFlag);
+            myValues.assign(myBoardSlotMapper.GetSlotsCount(), std::numeric_limits<float>::quiet_NaN());
+        }
+
+        const Utils::BoardSlotMapper& GetBoardSlotMapper() const { return myBoardSlotMapper; }
+
+        bool Contains(const uint32_t& aBoard) const
+        {
+            return !std::isnan(myValues[myBoardSlotMapper.GetSlot(aBoard)]);
+        }
+
+        float Get(const uint32_t& aBoard) const
+        {
+            assert(Contains(aBoard));
+            return myValues[myBoardSlotMapper.GetSlot(aBoard)];
+        }
+
+        void Set(const uint32_t& aBoard, float aValue)
+        {
+            myValues[myBoardSlotMapper.GetSlot(aBoard)] = aValue;
+        }
+
+        void Add(const uint32_t& aBoard, float aDelta)
+        {
+            assert(Contains(aBoard));
+            myValues[myBoardSlotMapper.GetSlot(aBoard)] += aDelta;
+        }
+
+        // Dense values addressed by slot, GetSlotsCount() entries of the board mapping
+        const float* GetSlotValues() const { return myValues.data(); }
+
+        // Bulk copy of the values laid out by a storage with the same board mapping
+        void SetSlotValues(const float* someSlotValues)
+        {
+            std::copy(someSlotValues, someSlotValues + myValues.size(), myValues.begin());
+        }
+
+        // Replaces every slot with the mean of the same slot across storages sharing this board mapping
+        void SetToAverageOf(const std::vector<const BoardIndexedStorage*>& someStorages)
+        {
+            assert(!someStorages.empty());
+
+            for (uint32_t slot = 0; slot < myValues.size(); ++slot)
+            {
+                auto valuesSum = 0.f;
+
+                for (const auto* storage : someStorages)
+                {
+                    assert(storage->myBoardSlotMapper == myBoardSlotMapper);
+                    valuesSum += storage->myValues[slot];
+                }
+
+                myValues[slot] = valuesSum / someStorages.size();
+            }
+        }
+
+        template<class Archive>
+        void save(Archive & archive) const
+        {
+            std::unordered_map<uint32_t, float> boardValues;
+
+            for (uint32_t slot = 0; slot < myValues.size(); ++slot)
+            {
+                if (!std::isnan(myValues[slot]))
+                {
+                    boardValues.insert(std::make_pair(myBoardSlotMapper.GetBoard(slot), myValues[slot]));
+                }
+            }
+
+            archive(CEREAL_NVP(myBoardSlotMapper), CEREAL_NVP(boardValues));
+        }
+
+        template<class Archive>
+        void load(Archive & archive)
+        {
+            std::unordered_map<uint32_t, float> boardValues;
+
+            // Policies saved before the board indexed storages hold the map of every board value in place of this node
+            if (RL::IsNextNode(archive, "myBoardSlotMapper"))
+            {
+                archive(CEREAL_NVP(myBoardSlotMapper), CEREAL_NVP(boardValues));
+            }
+            else
+            {
+                myBoardSlotMapper.SetMapping(false, false);
+                cereal::load(archive, boardValues);
+            }
+
+            myValues.assign(myBoardSlotMapper.GetSlotsCount(), std::numeric_limits<float>::quiet_NaN());
+
+            for (const auto& boardValue : boardValues)
+            {
+                Set(boardValue.first, boardValue.second);
+            }
+        }
+
+    private:
+        std::vector<float> myValues;
+        Utils::BoardSlotMapper myBoardSlotMapper;
+    };
+}
+
+#endif //RLEXPERIMENTS_BOARDINDEXEDSTORAGE_H
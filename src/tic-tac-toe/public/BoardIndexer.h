@@ -0,0 +1,144 @@
+//
+// Created by Gianmarco Picarella on 10/10/22.
+//
+
+#ifndef RLEXPERIMENTS_BOARDINDEXER_H
+#define RLEXPERIMENTS_BOARDINDEXER_H
+
+#include <cstdint>
+#include <vector>
+
+#include <cereal/cereal.hpp>
+
+namespace TTT
+{
+namespace Utils
+{
+    // Number of base-3 ranks, one for every combination of the nine ternary cells
+    constexpr uint32_t BoardRanksCount = 19683;
+
+    namespace Detail
+    {
+        // Base-3 value of every group of three 2-bit cells
+        struct TripletRanks
+        {
+            constexpr TripletRanks() : myRanks{}
+            {
+                for (uint32_t cells = 0; cells < 64; ++cells)
+                {
+                    myRanks[cells] = static_cast<uint16_t>((cells & 0x3) + 3 * ((cells >> 2) & 0x3) + 9 * ((cells >> 4) & 0x3));
+                }
+            }
+
+            uint16_t myRanks[64];
+        };
+    }
+
+    // Maps a legal board to a dense index in [0, BoardRanksCount) by reading its cells as ternary digits
+    inline uint32_t GetBoardRank(const uint32_t aBoard)
+    {
+        static constexpr Detail::TripletRanks tripletRanks{};
+
+        return tripletRanks.myRanks[aBoard & 0x3F] +
+               27 * tripletRanks.myRanks[(aBoard >> 6) & 0x3F] +
+               729 * tripletRanks.myRanks[(aBoard >> 12) & 0x3F];
+    }
+
+    uint32_t GetBoardFromRank(const uint32_t aRank);
+
+    // Exchanges crosses and noughts
+    inline uint32_t SwapColours(const uint32_t aBoard)
+    {
+        return ((aBoard & 0x15555) << 1) | ((aBoard >> 1) & 0x15555);
+    }
+
+    // Number of rotations and reflections of the square (D4 group)
+    constexpr uint32_t BoardSymmetriesCount = 8;
+
+    // Applies one of the eight rotations/reflections to the board, 0 being the identity
+    uint32_t TransformBoard(const uint32_t aBoard, const uint32_t aSymmetryIndex);
+
+    // Precomputed rank to slot remapping tables, built once per process on first access.
+    // The canonical rank of a board is the smallest rank among its eight symmetric boards. Symmetry reduced slots only
+    // address canonical ranks, numbered densely in increasing order, so reduced storages hold CanonicalRanksCount values.
+    class BoardSymmetries
+    {
+    public:
+        static const BoardSymmetries& GetInstance();
+
+        // Returns nullptr when neither symmetry reduction nor colour swapping is requested
+        const uint16_t* GetSlotsMapping(const bool aSymmetryReducedFlag, const bool aColourSwappedFlag) const;
+
+        // Rank addressed by every symmetry reduced slot, the slot is the rank itself otherwise
+        const uint16_t* GetCanonicalSlotRanks() const { return myCanonicalSlotRanks.data(); }
+        uint32_t GetCanonicalRanksCount() const { return static_cast<uint32_t>(myCanonicalSlotRanks.size()); }
+
+    private:
+        BoardSymmetries();
+
+        std::vector<uint16_t> myCanonicalSlots;
+        std::vector<uint16_t> myColourSwappedRanks;
+        std::vector<uint16_t> myCanonicalColourSwappedSlots;
+        std::vector<uint16_t> myCanonicalSlotRanks;
+    };
+
+    // Maps boards to the slots of a dense storage, optionally through the symmetry and colour swap tables
+    class BoardSlotMapper
+    {
+    public:
+        void SetMapping(const bool aSymmetryReducedFlag, const bool aColourSwappedFlag)
+        {
+            const auto& boardSymmetries = BoardSymmetries::GetInstance();
+
+            myIsSymmetryReduced = aSymmetryReducedFlag;
+            myIsColourSwapped = aColourSwappedFlag;
+            mySlotsMapping = boardSymmetries.GetSlotsMapping(aSymmetryReducedFlag, aColourSwappedFlag);
+            mySlotRanks = aSymmetryReducedFlag ? boardSymmetries.GetCanonicalSlotRanks() : nullptr;
+            mySlotsCount = aSymmetryReducedFlag ? boardSymmetries.GetCanonicalRanksCount() : BoardRanksCount;
+        }
+
+        bool IsSymmetryReduced() const { return myIsSymmetryReduced; }
+        bool IsColourSwapped() const { return myIsColourSwapped; }
+
+        // Size of a dense storage using this mapping
+        uint32_t GetSlotsCount() const { return mySlotsCount; }
+
+        uint32_t GetSlot(const uint32_t aBoard) const
+        {
+            const auto rank = GetBoardRank(aBoard);
+            return mySlotsMapping != nullptr ? mySlotsMapping[rank] : rank;
+        }
+
+        // Board addressing aSlot, as seen by the agent
+        uint32_t GetBoard(const uint32_t aSlot) const
+        {
+            const auto board = GetBoardFromRank(mySlotRanks != nullptr ? mySlotRanks[aSlot] : aSlot);
+            return myIsColourSwapped ? SwapColours(board) : board;
+        }
+
+        bool operator==(const BoardSlotMapper& anOther) const { return mySlotsMapping == anOther.mySlotsMapping; }
+
+        template<class Archive>
+        void save(Archive & archive) const
+        {
+            archive(CEREAL_NVP(myIsSymmetryReduced), CEREAL_NVP(myIsColourSwapped));
+        }
+
+        template<class Archive>
+        void load(Archive & archive)
+        {
+            archive(CEREAL_NVP(myIsSymmetryReduced), CEREAL_NVP(myIsColourSwapped));
+            SetMapping(myIsSymmetryReduced, myIsColourSwapped);
+        }
+
+    private:
+        bool myIsSymmetryReduced { false };
+        bool myIsColourSwapped { false };
+        const uint16_t* mySlotsMapping { nullptr };
+        const uint16_t* mySlotRanks { nullptr };
+        uint32_t mySlotsCount { BoardRanksCount };
+    };
+}
+}
+
+#endif //RLEXPERIMENTS_BOARDINDEXER_H
@@ -0,0 +1,172 @@
+//
+// Created by Gianmarco Picarella on 17/10/22.
+//
+
+#ifndef RLEXPERIMENTS_EPISODEOBSERVERS_H
+#define RLEXPERIMENTS_EPISODEOBSERVERS_H
+
+#include <algorithm>
+#include <cstdint>
+#include <initializer_list>
+#include <mutex>
+#include <tuple>
+#include <utility>
+#include <vector>
+
+#include "GameUtils.h"
+
+namespace TTT
+{
+    // Outcome of consecutive episodes, from the learner point of view
+    struct EpisodesSummary
+    {
+        int myFirstEpisodeIndex { 0 };
+        int myEpisodesCount { 0 };
+        uint64_t myMovesCount { 0 };
+
+        // Indexed by BoardStatus
+        int myResultsCounts[4] { 0, 0, 0, 0 };
+    };
+
+namespace Utils
+{
+    // Episode observer folding the episodes into summaries and handing one to each summary observer
+    // every aSummaryInterval episodes (and the last partial one when the simulation ends).
+    // Summary observers are any class with
+    //   void OnEpisodesSummary(const EpisodesSummary& aSummary)
+    // and are called directly, so the per-episode cost is a status check and a few increments.
+    template <typename... SummaryObservers>
+    class EpisodesSummarizer
+    {
+    public:
+        EpisodesSummarizer(const Player aLearnerId, int aSummaryInterval, SummaryObservers&... someSummaryObservers) :
+                myLearnerId(aLearnerId),
+                mySummaryInterval(std::max(1, aSummaryInterval)),
+                mySummaryObservers(someSummaryObservers...)
+        {
+        }
+
+        void OnEpisodeEnd(const std::vector<uint32_t>& aGameplayHistory, int anEpisodeIndex)
+        {
+            if (mySummary.myEpisodesCount == 0)
+            {
+                mySummary.myFirstEpisodeIndex = anEpisodeIndex;
+            }
+
+            ++mySummary.myEpisodesCount;
+            mySummary.myMovesCount += aGameplayHistory.size();
+            ++mySummary.myResultsCounts[static_cast<uint32_t>(GetBoardStatus(myLearnerId, aGameplayHistory.back()))];
+
+            if (mySummary.myEpisodesCount == mySummaryInterval)
+            {
+                Flush();
+            }
+        }
+
+        void OnSimulationEnd()
+        {
+            if (mySummary.myEpisodesCount > 0)
+            {
+                Flush();
+            }
+        }
+
+    private:
+        void Flush()
+        {
+            NotifySummary(std::index_sequence_for<SummaryObservers...>{});
+            mySummary = EpisodesSummary{};
+        }
+
+        template <std::size_t... ObserverIndices>
+        void NotifySummary(std::index_sequence<ObserverIndices...>)
+        {
+            (void) std::initializer_list<int> { (std::get<ObserverIndices>(mySummaryObservers).OnEpisodesSummary(mySummary), 0)... };
+        }
+
+        Player myLearnerId;
+        int mySummaryInterval;
+        std::tuple<SummaryObservers&...> mySummaryObservers;
+        EpisodesSummary mySummary;
+    };
+
+    template <typename... SummaryObservers>
+    EpisodesSummarizer<SummaryObservers...> MakeEpisodesSummarizer(const Player aLearnerId, int aSummaryInterval,
+                                                                   SummaryObservers&... someSummaryObservers)
+    {
+        return EpisodesSummarizer<SummaryObservers...>(aLearnerId, aSummaryInterval, someSummaryObservers...);
+    }
+
+    // Summary observer shared by the summarizers of concurrent workers, forwarding their summaries under a lock.
+    // Workers only contend once per summary instead of once per episode.
+    template <typename... SummaryObservers>
+    class SynchronizedSummaryObserver
+    {
+    public:
+        explicit SynchronizedSummaryObserver(SummaryObservers&... someSummaryObservers) : mySummaryObservers(someSummaryObservers...) {}
+
+        void OnEpisodesSummary(const EpisodesSummary& aSummary)
+        {
+            std::lock_guard<std::mutex> lock(myMutex);
+            NotifySummary(aSummary, std::index_sequence_for<SummaryObservers...>{});
+        }
+
+    private:
+        template <std::size_t... ObserverIndices>
+        void NotifySummary(const EpisodesSummary& aSummary, std::index_sequence<ObserverIndices...>)
+        {
+            (void) std::initializer_list<int> { (std::get<ObserverIndices>(mySummaryObservers).OnEpisodesSummary(aSummary), 0)... };
+        }
+
+        std::mutex myMutex;
+        std::tuple<SummaryObservers&...> mySummaryObservers;
+    };
+
+    // Summary observer forwarding to an observer that may not exist, for the ones that are only built on request
+    template <typename SummaryObserver>
+    class OptionalSummaryObserver
+    {
+    public:
+        explicit OptionalSummaryObserver(SummaryObserver* aSummaryObserverPtr) : mySummaryObserverPtr(aSummaryObserverPtr) {}
+
+        void OnEpisodesSummary(const EpisodesSummary& aSummary)
+        {
+            if (mySummaryObserverPtr != nullptr)
+            {
+                mySummaryObserverPtr->OnEpisodesSummary(aSummary);
+            }
+        }
+
+    private:
+        SummaryObserver* mySummaryObserverPtr;
+    };
+
+    // Episode observer calling a function object after every episode, for the few observers that need every trajectory.
+    // The call is resolved at compile time, unlike a std::function.
+    template <typename Callback>
+    class CallbackEpisodeObserver
+    {
+    public:
+        explicit CallbackEpisodeObserver(Callback aCallback) : myCallback(std::move(aCallback)) {}
+
+        template <typename GameplayHistory>
+        void OnEpisodeEnd(const GameplayHistory& aGameplayHistory, int anEpisodeIndex)
+        {
+            myCallback(aGameplayHistory, anEpisodeIndex);
+        }
+
+        void OnSimulationEnd() {}
+
+    private:
+        Callback myCallback;
+    };
+
+    template <typename Callback>
+    CallbackEpisodeObserver<Callback> MakeCallbackEpisodeObserver(Callback aCallback)
+    {
+        return CallbackEpisodeObserver<Callback>(std::move(aCallback));
+    }
+}
+}
+
+#endif //RLEXPERIMENTS_EPISODEOBSERVERS_H
@@ -6,24 +6,57 @@
 #define RLEXPERIMENTS_EPSILONOPTIMALOPPONENT_H
 
 #include <Agent.h>
+#include <cassert>
 #include <cstdint>
+#include <limits>
 
 #include "PlayerEnum.h"
+#include "GameUtils.h"
+#include "SolvedGameTable.h"
 
 namespace TTT
 {
-class EpsilonOptimalOpponent : public RL::Agent<Player, uint32_t, uint32_t>
+class EpsilonOptimalOpponent final : public RL::Agent<Player, uint32_t, uint32_t>
     {
     public:
         using Base = RL::Agent<Player, uint32_t, uint32_t>;
 
-        EpsilonOptimalOpponent(const Player& aTrainerId, float aRandomEpsilon) : Base(aTrainerId), myRandomEpsilon(aRandomEpsilon) {}
+        EpsilonOptimalOpponent(const Player& aTrainerId, float aRandomEpsilon) :
+                Base(aTrainerId), myRandomEpsilon(aRandomEpsilon), mySolvedGameTable(&SolvedGameTable::GetInstance()) {}
 
-        uint32_t GetNextAction(const uint32_t& aCurrentState);
+        uint32_t GetNextAction(const uint32_t& aCurrentState)
+        {
+            if (myRandomGenerator.NextFloat() < myRandomEpsilon)
+            {
+                const auto nextMoves = TTT::Utils::GenerateMoves(myId, aCurrentState);
+
+                assert(nextMoves.size() > 0);
+
+                return nextMoves[myRandomGenerator.NextIndex(nextMoves.size())];
+            }
+
+            const auto optimalMoves = mySolvedGameTable->GetOptimalMoves(aCurrentState, myId);
+
+            assert(!optimalMoves.empty());
+
+            const auto optimalMove = optimalMoves[myRandomGenerator.NextIndex(optimalMoves.size())];
+
+#ifdef DEBUG_FLAG
+            const auto nextPlayer = static_cast<Player>((~static_cast<uint32_t>(myId)) & 0x3);
+
+            assert(TicTacToeMinimax(optimalMove, nextPlayer, std::numeric_limits<int>::min(), std::numeric_limits<int>::max()) ==
+                   mySolvedGameTable->GetValue(aCurrentState, myId) && "Solved game table disagrees with minimax");
+#endif
+
+            return optimalMove;
+        }
+
+        // Alpha-beta search of the game value from the opponent point of view, reference of the solved game table
+        int TicTacToeMinimax(const uint32_t aBoard, const Player aPlayer,  int anAlpha, int aBeta);
 
     private:
         float myRandomEpsilon;
-        int TicTacToeMinimax(const uint32_t aBoard, const Player aPlayer,  int anAlpha, int aBeta);
+        const SolvedGameTable* mySolvedGameTable;
     };
 
 }
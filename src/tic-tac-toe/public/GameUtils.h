@@ -9,13 +9,16 @@
 #include <cstdint>
 #include <set>
 #include <vector>
-#include <random>
+#include <cassert>
+#include <limits>
 
 #include "PlayerEnum.h"
 #include "BoardStatusEnum.h"
+#include "TrainingMetrics.h"
 
 #include <Agent.h>
 #include <LearningPolicy.h>
+#include <FixedCapacityList.h>
 
 namespace TTT
 {
@@ -23,63 +26,240 @@ namespace Utils
 {
 std::string BoardToString(const uint32_t aBoard);
 
-BoardStatus GetBoardStatus(const Player aMovingPlayer, const uint32_t aBoard);
+namespace Detail
+{
+    // Low bit of every cell belonging to one of the eight winning lines (rows, columns and diagonals)
+    constexpr uint32_t WinningLinesMasks[8] = { 0x15000, 0x00540, 0x00015, 0x10410, 0x04104, 0x01041, 0x10101, 0x01110 };
+
+    constexpr uint32_t AllCellsMask = 0x15555;
+}
+
+// Splits the board into one occupancy mask per player and tests both against the winning lines
+inline BoardStatus GetBoardStatus(const Player aMovingPlayer, const uint32_t aBoard)
+{
+    const auto crossCells = aBoard & Detail::AllCellsMask;
+    const auto noughtCells = (aBoard >> 1) & Detail::AllCellsMask;
+
+    auto hasCrossLine = false;
+    auto hasNoughtLine = false;
+
+    for (const auto lineMask : Detail::WinningLinesMasks)
+    {
+        hasCrossLine |= (crossCells & lineMask) == lineMask;
+        hasNoughtLine |= (noughtCells & lineMask) == lineMask;
+    }
+
+    assert(!(hasCrossLine && hasNoughtLine) && "Both players cannot have a Tris");
+
+    if (hasCrossLine || hasNoughtLine)
+    {
+        return hasCrossLine == (aMovingPlayer == Player::Cross) ? BoardStatus::Win : BoardStatus::Lose;
+    }
+
+    return (crossCells | noughtCells) == Detail::AllCellsMask ? BoardStatus::Draw : BoardStatus::Intermediate;
+}
+
+// A board has at most nine empty cells, hence at most nine moves
+using MoveList = RL::FixedCapacityList<uint32_t, 9>;
+
+// Returns a mask with the low bit of every empty 2-bit cell set
+inline uint32_t GetEmptyCellsMask(const uint32_t aBoard)
+{
+    return ~(aBoard | (aBoard >> 1)) & 0x15555;
+}
+
+inline MoveList GenerateMoves(const Player aPlayerToMove, const uint32_t aCurrentBoard)
+{
+    assert(GetBoardStatus(aPlayerToMove, aCurrentBoard) == BoardStatus::Intermediate &&
+           "Cannot generate moves from a full board");
+
+    MoveList moves;
 
-std::vector<uint32_t> GenerateMoves(const Player aPlayerToMove, const uint32_t aCurrentBoard);
+    const auto playerId = static_cast<uint32_t>(aPlayerToMove);
+
+    for (auto emptyCells = GetEmptyCellsMask(aCurrentBoard); emptyCells != 0; emptyCells &= emptyCells - 1)
+    {
+        const auto positionIndex = static_cast<uint32_t>(__builtin_ctz(emptyCells));
+        moves.push_back(aCurrentBoard | (playerId << positionIndex));
+    }
+
+    return moves;
+}
+
+// The 3x3 board behind the static game interface of MNKGame, for the helpers shared by every board (see QLearnerJobs.h
+// and the simulations below)
+struct TicTacToeGame
+{
+    static constexpr int CellsCount = 9;
+
+    using Board = uint32_t;
+    using MoveList = Utils::MoveList;
+
+    static BoardStatus GetBoardStatus(const Player aMovingPlayer, const Board aBoard) { return Utils::GetBoardStatus(aMovingPlayer, aBoard); }
+
+    static MoveList GenerateMoves(const Player aPlayerToMove, const Board aCurrentBoard) { return Utils::GenerateMoves(aPlayerToMove, aCurrentBoard); }
+};
 
 void GenerateBoards(const Player anAgentPlayer, const Player aStartingPlayer, std::set<uint32_t>& someOutValidBoards);
 
-template <typename LearningSettings>
-void Simulate(RL::LearningPolicy<TTT::Player, uint32_t, uint32_t, LearningSettings, TTT::BoardStatus>& aLearningAgent,
-              RL::Agent<TTT::Player, uint32_t, uint32_t>& aTrainerAgent,
+// Plays a full episode from the empty board, appending every move to someOutGameplayHistory
+template <typename Game = TicTacToeGame, typename LearningAgent, typename TrainerAgent>
+void PlayEpisode(LearningAgent& aLearningAgent,
+                 TrainerAgent& aTrainerAgent,
+                 bool aFirstMoveFromLearnerFlag,
+                 std::vector<typename Game::Board>& someOutGameplayHistory)
+{
+    typename Game::Board board {};
+    TTT::Player player = aFirstMoveFromLearnerFlag ? aLearningAgent.GetAgentId() : aTrainerAgent.GetAgentId();
+
+    while (Game::GetBoardStatus(player, board) == TTT::BoardStatus::Intermediate)
+    {
+        if (player == aLearningAgent.GetAgentId())
+        {
+            board = aLearningAgent.GetNextAction(board);
+        }
+        else
+        {
+            board = aTrainerAgent.GetNextAction(board);
+        }
+
+        // Add new move
+        someOutGameplayHistory.push_back(board);
+
+        // Swap player
+        player = static_cast<TTT::Player>((~static_cast<uint32_t>(player)) & 0x3);
+    }
+}
+
+namespace Detail
+{
+    // Exploration rate of the learning settings, NaN when they do not have one
+    template <typename LearningSettings>
+    auto GetRandomEpsilon(const LearningSettings& someSettings, int) -> decltype(static_cast<float>(someSettings.myRandomEpsilon))
+    {
+        return someSettings.myRandomEpsilon;
+    }
+
+    template <typename LearningSettings>
+    float GetRandomEpsilon(const LearningSettings&, long)
+    {
+        return std::numeric_limits<float>::quiet_NaN();
+    }
+
+    // Learns from a finished episode, online learners only close their pending transition
+    template <typename LearningAgent, typename Board>
+    void EndLearnerEpisode(LearningAgent& aLearningAgent, const std::vector<Board>& aGameplayHistory)
+    {
+        if (aLearningAgent.IsUpdatingOnline())
+        {
+            aLearningAgent.EndEpisode(aGameplayHistory.back());
+        }
+        else if (aLearningAgent.GetLearningSettings().myIsTraining)
+        {
+            aLearningAgent.Update(aGameplayHistory);
+        }
+    }
+
+    template <typename Game = TicTacToeGame, typename LearningAgent>
+    void RecordEpisode(TrainingMetrics* someTrainingMetrics, const LearningAgent& aLearningAgent,
+                       const std::vector<typename Game::Board>& aGameplayHistory)
+    {
+        if (someTrainingMetrics != nullptr)
+        {
+            someTrainingMetrics->RecordEpisode(aGameplayHistory.size(),
+                                               Game::GetBoardStatus(aLearningAgent.GetAgentId(), aGameplayHistory.back()),
+                                               aLearningAgent.GetStatistics(),
+                                               GetRandomEpsilon(aLearningAgent.GetLearningSettings(), 0));
+        }
+    }
+
+    template <typename LearningAgent>
+    void TakeSnapshot(TrainingMetrics* someTrainingMetrics, const LearningAgent& aLearningAgent)
+    {
+        if (someTrainingMetrics != nullptr)
+        {
+            someTrainingMetrics->TakeSnapshot(aLearningAgent.GetStatistics(), GetRandomEpsilon(aLearningAgent.GetLearningSettings(), 0));
+        }
+    }
+}
+
+// Episode observers are resolved at compile time: any class with
+//   void OnEpisodeEnd(const std::vector<uint32_t>& aGameplayHistory, int anEpisodeIndex)
+//   void OnSimulationEnd()
+// can observe a simulation, see EpisodeObservers.h for the summarizing and callback observers.
+// Simulations of another Game pass a std::vector<typename Game::Board> history instead.
+struct NullEpisodeObserver
+{
+    template <typename GameplayHistory>
+    void OnEpisodeEnd(const GameplayHistory&, int) {}
+    void OnSimulationEnd() {}
+};
+
+// Templated on the agents' types: given base references the moves go through virtual calls, given the concrete types
+// of a static learner (e.g. StaticTicTacToeQLearner) and a final opponent the episode loop compiles to direct calls.
+// Game selects the board, e.g. an MNKGame for MNKQLearner and the MNK opponents.
+template <typename Game = TicTacToeGame, typename LearningAgent, typename TrainerAgent, typename EpisodeObserver = NullEpisodeObserver>
+void Simulate(LearningAgent& aLearningAgent,
+              TrainerAgent& aTrainerAgent,
               int anIterationsCount,
               bool aFirstMoveFromLearnerFlag = true,
-              std::function<void(const std::vector<uint32_t>&, int)> onEpisodeEndCallback = nullptr)
+              EpisodeObserver&& anEpisodeObserver = EpisodeObserver{},
+              TrainingMetrics* someTrainingMetrics = nullptr)
 {
-        static std::random_device dev;
-        static std::mt19937 rng(dev());
-
-        std::vector<uint32_t> gameplayHistory;
+        std::vector<typename Game::Board> gameplayHistory;
+        gameplayHistory.reserve(Game::CellsCount);
 
         for (auto episodeIdx = 0; episodeIdx < anIterationsCount; ++episodeIdx)
         {
-            uint32_t board = 0x00000000;
-            TTT::Player player = aFirstMoveFromLearnerFlag ? aLearningAgent.GetAgentId() : aTrainerAgent.GetAgentId();
-
-            while (TTT::Utils::GetBoardStatus(player, board) == TTT::BoardStatus::Intermediate)
-            {
-                if (player == aLearningAgent.GetAgentId())
-                {
-                    board = aLearningAgent.GetNextAction(board);
-                }
-                else
-                {
-                    board = aTrainerAgent.GetNextAction(board);
-                }
-
-                // Add new move
-                gameplayHistory.push_back(board);
-
-                // Swap player
-                player = static_cast<TTT::Player>((~static_cast<uint32_t>(player)) & 0x3);
-            }
-
-            if (onEpisodeEndCallback != nullptr)
-            {
-                onEpisodeEndCallback(gameplayHistory, episodeIdx);
-            }
+            PlayEpisode<Game>(aLearningAgent, aTrainerAgent, aFirstMoveFromLearnerFlag, gameplayHistory);
 
-            // Update values
+            anEpisodeObserver.OnEpisodeEnd(gameplayHistory, episodeIdx);
 
-            if (aLearningAgent.GetLearningSettings().myIsTraining)
-            {
-                aLearningAgent.Update(gameplayHistory);
-            }
+            // Update values
+            Detail::EndLearnerEpisode(aLearningAgent, gameplayHistory);
+            Detail::RecordEpisode<Game>(someTrainingMetrics, aLearningAgent, gameplayHistory);
 
             // Clear history
             gameplayHistory.clear();
         }
+
+        anEpisodeObserver.OnSimulationEnd();
+
+        Detail::TakeSnapshot(someTrainingMetrics, aLearningAgent);
     }
+
+// Self-play: two learners of opposite sides train against each other, neither needs a scripted opponent.
+// Every episode is played once and both learners update from the same trajectory, each one from its own point of view;
+// their tables are built from the shared StateGraph. Observer and training metrics follow aFirstLearner.
+template <typename FirstLearner, typename SecondLearner, typename EpisodeObserver = NullEpisodeObserver>
+void SelfPlaySimulate(FirstLearner& aFirstLearner,
+                      SecondLearner& aSecondLearner,
+                      int anIterationsCount,
+                      bool aFirstMoveFromFirstLearnerFlag = true,
+                      EpisodeObserver&& anEpisodeObserver = EpisodeObserver{},
+                      TrainingMetrics* someTrainingMetrics = nullptr)
+{
+    assert(aFirstLearner.GetAgentId() != aSecondLearner.GetAgentId() && "Self-play learners must play opposite sides");
+
+    std::vector<uint32_t> gameplayHistory;
+
+    for (auto episodeIdx = 0; episodeIdx < anIterationsCount; ++episodeIdx)
+    {
+        PlayEpisode(aFirstLearner, aSecondLearner, aFirstMoveFromFirstLearnerFlag, gameplayHistory);
+
+        anEpisodeObserver.OnEpisodeEnd(gameplayHistory, episodeIdx);
+
+        Detail::EndLearnerEpisode(aFirstLearner, gameplayHistory);
+        Detail::EndLearnerEpisode(aSecondLearner, gameplayHistory);
+        Detail::RecordEpisode(someTrainingMetrics, aFirstLearner, gameplayHistory);
+
+        gameplayHistory.clear();
+    }
+
+    anEpisodeObserver.OnSimulationEnd();
+
+    Detail::TakeSnapshot(someTrainingMetrics, aFirstLearner);
+}
 }
 }
 
@@ -0,0 +1,98 @@
+//
+// Created by Gianmarco Picarella on 17/10/22.
+//
+
+#ifndef RLEXPERIMENTS_HYPERPARAMETERSWEEP_H
+#define RLEXPERIMENTS_HYPERPARAMETERSWEEP_H
+
+#include <array>
+#include <cstdint>
+#include <functional>
+#include <string>
+#include <vector>
+
+#include <RandomGenerator.h>
+
+#include "TicTacToeSettings.h"
+
+#include "PlayerEnum.h"
+#include "BoardStatusEnum.h"
+
+namespace TTT
+{
+namespace Utils
+{
+    // Rewards in the -r order: win, draw, lose, intermediate
+    using RewardValues = std::array<float, 4>;
+
+    struct SweepConfiguration
+    {
+        float myGamma { 0.9f };
+        float myRandomEpsilon { 0.3f };
+        float myRandomEpsilonDecay { 0.000001f };
+        float myLearningRate { 0.5f };
+        RewardValues myRewards { { 1.f, 0.f, -1.f, 0.5f } };
+    };
+
+    // Values tried for each hyperparameter. Grid sweeps try every combination, random sweeps draw every
+    // hyperparameter uniformly between the smallest and the largest of its values, and one of the reward vectors.
+    struct SweepSpace
+    {
+        std::vector<float> myGammas { 0.9f };
+        std::vector<float> myRandomEpsilons { 0.3f };
+        std::vector<float> myRandomEpsilonDecays { 0.000001f };
+        std::vector<float> myLearningRates { 0.5f };
+        std::vector<RewardValues> myRewards { { { 1.f, 0.f, -1.f, 0.5f } } };
+    };
+
+    std::vector<SweepConfiguration> MakeGridConfigurations(const SweepSpace& aSweepSpace);
+    std::vector<SweepConfiguration> MakeRandomConfigurations(const SweepSpace& aSweepSpace, int aConfigurationsCount,
+                                                             RL::RandomGenerator& aRandomGenerator);
+
+    struct SweepSettings
+    {
+        Player myAgentSide { Player::Cross };
+        bool myIsAgentDelayed { false };
+
+        int myTrainingEpisodesCount { 50000 };
+
+        // Training opponent, negative for the random one
+        float myTrainingOpponentEpsilon { -1.f };
+
+        // Greedy episodes played by every trained agent against the random and the optimal opponents
+        int myEvaluationEpisodesCount { 10000 };
+
+        int myThreadsCount { 1 };
+
+        // Configuration i draws from streams 4i to 4i + 3 of the seed, so results do not depend on the threads count
+        uint64_t mySeed { 0 };
+    };
+
+    struct SweepResult
+    {
+        int myConfigurationIndex { 0 };
+        SweepConfiguration myConfiguration;
+
+        double myTrainingSeconds { 0.0 };
+
+        // Indexed by BoardStatus, from the agent point of view
+        int myRandomOpponentResults[4] { 0, 0, 0, 0 };
+        int myOptimalOpponentResults[4] { 0, 0, 0, 0 };
+
+        // Mean of the wins minus the loses per episode against both opponents, the ranking key
+        double myScore { 0.0 };
+    };
+
+    // Trains and evaluates every configuration on a pool of myThreadsCount threads, each one claiming the next
+    // configuration when done with its previous one. Learners and opponents are the static types (no virtual calls),
+    // the boards graph and the solved game table are shared read-only by all the threads.
+    // Returns the results ranked by decreasing score. aConfigurationDoneCallback is called from the workers.
+    std::vector<SweepResult> RunSweep(const std::vector<SweepConfiguration>& someConfigurations, const SweepSettings& someSweepSettings,
+                                      const std::function<void(const SweepResult&)>& aConfigurationDoneCallback = {});
+
+    // CSV for paths ending with .csv, JSON otherwise. Returns false if the file cannot be written.
+    bool SaveSweepResults(const std::vector<SweepResult>& someSweepResults, const std::string& aPath);
+}
+}
+
+#endif //RLEXPERIMENTS_HYPERPARAMETERSWEEP_H
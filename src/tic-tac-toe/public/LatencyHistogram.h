@@ -0,0 +1,102 @@
+//
+// Created by Gianmarco Picarella on 17/10/22.
+//
+
+#ifndef RLEXPERIMENTS_LATENCYHISTOGRAM_H
+#define RLEXPERIMENTS_LATENCYHISTOGRAM_H
+
+#include <algorithm>
+#include <array>
+#include <cstdint>
+
+namespace TTT
+{
+namespace Utils
+{
+    // Fixed-size log-linear histogram of durations in nanoseconds.
+    // Every power of two is split in 16 linear buckets, so quantiles are reported within ~6% of the recorded values.
+    // Recording never allocates.
+    class LatencyHistogram
+    {
+    public:
+        LatencyHistogram() { Reset(); }
+
+        void Record(uint64_t aNanoseconds)
+        {
+            ++myCounts[GetBucketIndex(aNanoseconds)];
+            ++myCount;
+            myMax = std::max(myMax, aNanoseconds);
+        }
+
+        void Reset()
+        {
+            myCounts.fill(0);
+            myCount = 0;
+            myMax = 0;
+        }
+
+        uint64_t GetCount() const { return myCount; }
+        uint64_t GetMax() const { return myMax; }
+
+        // Upper bound of the bucket holding the given quantile (0 to 1)
+        uint64_t GetQuantile(double aQuantile) const
+        {
+            if (myCount == 0)
+            {
+                return 0;
+            }
+
+            const auto rank = std::max<uint64_t>(1, static_cast<uint64_t>(aQuantile * myCount + 0.5));
+            uint64_t cumulativeCount = 0;
+
+            for (uint32_t bucketIndex = 0; bucketIndex < BucketsCount; ++bucketIndex)
+            {
+                cumulativeCount += myCounts[bucketIndex];
+
+                if (cumulativeCount >= rank)
+                {
+                    return std::min(GetBucketUpperBound(bucketIndex), myMax);
+                }
+            }
+
+            return myMax;
+        }
+
+    private:
+        static constexpr uint32_t SubBucketsBits = 4;
+        static constexpr uint32_t SubBucketsCount = 1u << SubBucketsBits;
+        static constexpr uint32_t BucketsCount = (64 - SubBucketsBits + 1) * SubBucketsCount;
+
+        static uint32_t GetBucketIndex(uint64_t aValue)
+        {
+            if (aValue < SubBucketsCount)
+            {
+                return static_cast<uint32_t>(aValue);
+            }
+
+            const auto shift = static_cast<uint32_t>(63 - __builtin_clzll(aValue)) - SubBucketsBits;
+
+            return (shift + 1) * SubBucketsCount + static_cast<uint32_t>((aValue >> shift) & (SubBucketsCount - 1));
+        }
+
+        static uint64_t GetBucketUpperBound(uint32_t aBucketIndex)
+        {
+            if (aBucketIndex < SubBucketsCount)
+            {
+                return aBucketIndex;
+            }
+
+            const auto shift = aBucketIndex / SubBucketsCount - 1;
+            const auto lowerBound = static_cast<uint64_t>(SubBucketsCount + aBucketIndex % SubBucketsCount) << shift;
+
+            return lowerBound + ((1ull << shift) - 1);
+        }
+
+        std::array<uint64_t, BucketsCount> myCounts;
+        uint64_t myCount;
+        uint64_t myMax;
+    };
+}
+}
+
+#endif //RLEXPERIMENTS_LATENCYHISTOGRAM_H
@@ -0,0 +1,238 @@
+//
+// Created by Gianmarco Picarella on 17/10/22.
+//
+
+#ifndef RLEXPERIMENTS_MNKGAME_H
+#define RLEXPERIMENTS_MNKGAME_H
+
+#include <cassert>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <string>
+#include <type_traits>
+
+#include <FixedCapacityList.h>
+
+#include "PlayerEnum.h"
+#include "BoardStatusEnum.h"
+
+namespace TTT
+{
+    // One bitboard per player, indexed by Player - 1
+    template <typename Word>
+    struct MNKBoard
+    {
+        Word myCells[2] { 0, 0 };
+
+        bool operator==(const MNKBoard& anOther) const
+        {
+            return myCells[0] == anOther.myCells[0] && myCells[1] == anOther.myCells[1];
+        }
+
+        bool operator!=(const MNKBoard& anOther) const { return !(*this == anOther); }
+    };
+
+namespace Detail
+{
+    template <std::size_t BitsCount>
+    using BitboardWord = typename std::conditional<BitsCount <= 64, uint64_t, unsigned __int128>::type;
+
+    inline uint64_t MixBits(uint64_t aValue)
+    {
+        aValue = (aValue ^ (aValue >> 30)) * 0xBF58476D1CE4E5B9ull;
+        aValue = (aValue ^ (aValue >> 27)) * 0x94D049BB133111EBull;
+
+        return aValue ^ (aValue >> 31);
+    }
+
+    inline uint64_t GetWordKey(uint64_t aWord) { return MixBits(aWord); }
+    inline uint64_t GetWordKey(unsigned __int128 aWord) { return MixBits(static_cast<uint64_t>(aWord) ^ MixBits(static_cast<uint64_t>(aWord >> 64))); }
+
+    template <typename Word>
+    uint64_t GetBoardKey(const MNKBoard<Word>& aBoard)
+    {
+        return MixBits(GetWordKey(aBoard.myCells[0]) + 0x9E3779B97F4A7C15ull * GetWordKey(aBoard.myCells[1]));
+    }
+}
+
+    // m,n,k-game engine: Columns x Rows boards won by K aligned pieces, optionally with gravity (pieces drop to the
+    // lowest empty cell of a column, as in connect four).
+    // Cells are stored column by column with one spare bit on top of every column, so that shifting a bitboard by
+    // 1 (vertical), Rows + 1 (horizontal), Rows + 2 and Rows (diagonals) never wraps a line around the board edges.
+    // Boards fit a uint64_t up to 64 bits, a 128-bit word otherwise.
+    template <int Columns, int Rows, int K, bool HasGravity = false>
+    class MNKGame
+    {
+    public:
+        static_assert(Columns > 0 && Rows > 0 && K > 1, "Invalid board size");
+        static_assert(K <= Columns || K <= Rows, "K aligned pieces do not fit the board");
+        static_assert(Columns * (Rows + 1) <= 128, "Boards are limited to 128 bits");
+
+        static constexpr int ColumnsCount = Columns;
+        static constexpr int RowsCount = Rows;
+        static constexpr int LineLength = K;
+        static constexpr int CellsCount = Columns * Rows;
+        static constexpr int ColumnHeight = Rows + 1;
+
+        using Word = Detail::BitboardWord<static_cast<std::size_t>(Columns * ColumnHeight)>;
+        using Board = MNKBoard<Word>;
+        using MoveList = RL::FixedCapacityList<Board, static_cast<std::size_t>(CellsCount)>;
+
+        static constexpr int GetCellIndex(int aColumn, int aRow) { return aColumn * ColumnHeight + aRow; }
+
+        static constexpr Word GetCellMask(int aColumn, int aRow) { return Word(1) << GetCellIndex(aColumn, aRow); }
+
+        // Every cell of the board, spare bits excluded
+        static constexpr Word GetAllCellsMask()
+        {
+            return GetBottomCellsMask() * ((Word(1) << Rows) - 1);
+        }
+
+        // Lowest cell of every column
+        static constexpr Word GetBottomCellsMask()
+        {
+            return GetBottomCellsMask(Columns);
+        }
+
+        static constexpr bool HasLine(const Word someCells)
+        {
+            return HasLine(someCells, 1) ||
+                   HasLine(someCells, ColumnHeight) ||
+                   HasLine(someCells, ColumnHeight + 1) ||
+                   HasLine(someCells, ColumnHeight - 1);
+        }
+
+        static BoardStatus GetBoardStatus(const Player aMovingPlayer, const Board& aBoard)
+        {
+            const auto& movingPlayerCells = aBoard.myCells[static_cast<uint32_t>(aMovingPlayer) - 1];
+            const auto& otherPlayerCells = aBoard.myCells[2 - static_cast<uint32_t>(aMovingPlayer)];
+
+            const auto hasMovingPlayerLine = HasLine(movingPlayerCells);
+            const auto hasOtherPlayerLine = HasLine(otherPlayerCells);
+
+            assert(!(hasMovingPlayerLine && hasOtherPlayerLine) && "Both players cannot have a line");
+
+            if (hasMovingPlayerLine)
+            {
+                return BoardStatus::Win;
+            }
+
+            if (hasOtherPlayerLine)
+            {
+                return BoardStatus::Lose;
+            }
+
+            return (movingPlayerCells | otherPlayerCells) == GetAllCellsMask() ? BoardStatus::Draw : BoardStatus::Intermediate;
+        }
+
+        // Cells the next piece can be placed on
+        static Word GetPlayableCellsMask(const Board& aBoard)
+        {
+            const auto occupiedCells = aBoard.myCells[0] | aBoard.myCells[1];
+
+            if (HasGravity)
+            {
+                // Adding the bottom cells carries into the lowest empty cell of every column, full columns carry into their spare bit
+                return (occupiedCells + GetBottomCellsMask()) & GetAllCellsMask();
+            }
+
+            return ~occupiedCells & GetAllCellsMask();
+        }
+
+        static MoveList GenerateMoves(const Player aPlayerToMove, const Board& aCurrentBoard)
+        {
+            assert(GetBoardStatus(aPlayerToMove, aCurrentBoard) == BoardStatus::Intermediate &&
+                   "Cannot generate moves from a finished board");
+
+            MoveList moves;
+
+            const auto playerIndex = static_cast<uint32_t>(aPlayerToMove) - 1;
+
+            for (auto playableCells = GetPlayableCellsMask(aCurrentBoard); playableCells != 0; playableCells &= playableCells - 1)
+            {
+                auto nextBoard = aCurrentBoard;
+                nextBoard.myCells[playerIndex] |= playableCells & (~playableCells + 1);
+
+                moves.push_back(nextBoard);
+            }
+
+            return moves;
+        }
+
+        static int GetPiecesCount(const Board& aBoard)
+        {
+            return CountCells(aBoard.myCells[0]) + CountCells(aBoard.myCells[1]);
+        }
+
+        static int CountCells(uint64_t someCells) { return __builtin_popcountll(someCells); }
+        static int CountCells(unsigned __int128 someCells)
+        {
+            return __builtin_popcountll(static_cast<uint64_t>(someCells)) + __builtin_popcountll(static_cast<uint64_t>(someCells >> 64));
+        }
+
+        // 64-bit key of a board, well mixed for hashed tables
+        static uint64_t GetStateKey(const Board& aBoard)
+        {
+            return Detail::GetBoardKey(aBoard);
+        }
+
+        // Rows from the top, 'x' for cross, 'o' for nought and '.' for empty cells
+        static std::string BoardToString(const Board& aBoard)
+        {
+            std::string result;
+
+            for (auto row = Rows - 1; row >= 0; --row)
+            {
+                for (auto column = 0; column < Columns; ++column)
+                {
+                    const auto cellMask = GetCellMask(column, row);
+                    result += (aBoard.myCells[0] & cellMask) ? 'x' : (aBoard.myCells[1] & cellMask) ? 'o' : '.';
+                }
+
+                result += '\n';
+            }
+
+            return result;
+        }
+
+    private:
+        static constexpr Word GetBottomCellsMask(int aColumnsCount)
+        {
+            return aColumnsCount == 0 ? Word(0) : (GetBottomCellsMask(aColumnsCount - 1) << ColumnHeight) | Word(1);
+        }
+
+        // Halves the run length to check at every step: after folding by n cells, a set bit marks n + 1 aligned pieces
+        static constexpr bool HasLine(const Word someCells, const int aShift)
+        {
+            return HasAlignedRun(someCells, aShift, 1);
+        }
+
+        static constexpr bool HasAlignedRun(const Word someRuns, const int aShift, const int aRunLength)
+        {
+            return aRunLength >= K ? someRuns != 0 :
+                   2 * aRunLength <= K ? HasAlignedRun(someRuns & (someRuns >> (aShift * aRunLength)), aShift, 2 * aRunLength) :
+                   (someRuns & (someRuns >> (aShift * (K - aRunLength)))) != 0;
+        }
+    };
+
+    // Variants we train on
+    using MNKTicTacToe = MNKGame<3, 3, 3>;
+    using MNKGame4x4x4 = MNKGame<4, 4, 4>;
+    using MNKGame5x5x4 = MNKGame<5, 5, 4>;
+    using ConnectFour = MNKGame<7, 6, 4, true>;
+}
+
+namespace std
+{
+    template <typename Word>
+    struct hash<TTT::MNKBoard<Word>>
+    {
+        std::size_t operator()(const TTT::MNKBoard<Word>& aBoard) const
+        {
+            return TTT::Detail::GetBoardKey(aBoard);
+        }
+    };
+}
+
+#endif //RLEXPERIMENTS_MNKGAME_H
@@ -0,0 +1,110 @@
+//
+// Created by Gianmarco Picarella on 17/10/22.
+//
+
+#ifndef RLEXPERIMENTS_MNKOPPONENTS_H
+#define RLEXPERIMENTS_MNKOPPONENTS_H
+
+#include <cassert>
+#include <cstddef>
+#include <cstdint>
+
+#include <StaticAgent.h>
+
+#include "MNKGame.h"
+#include "PlayerEnum.h"
+#include "QLearnerJobs.h"
+
+namespace TTT
+{
+    // Uniform random moves on an m,n,k-game board
+    template <typename Game>
+    class MNKRandomOpponent final : public RL::StaticAgent<MNKRandomOpponent<Game>, Player, typename Game::Board, typename Game::Board>
+    {
+    public:
+        using Board = typename Game::Board;
+        using Base = RL::StaticAgent<MNKRandomOpponent<Game>, Player, Board, Board>;
+
+        MNKRandomOpponent(const Player& aTrainerId) : Base(aTrainerId) {}
+
+        Board GetNextAction(const Board& aCurrentState)
+        {
+            return Utils::SelectRandomMove<Game>(this->myId, aCurrentState, this->myRandomGenerator);
+        }
+    };
+
+    // Larger boards cannot be solved like the 3x3 one (see SolvedGameTable), so this opponent only looks one move ahead:
+    // it completes its own lines, otherwise blocks the lines the other player would complete, otherwise plays at random.
+    // With probability epsilon it plays a random move instead.
+    template <typename Game>
+    class MNKTacticalOpponent final : public RL::StaticAgent<MNKTacticalOpponent<Game>, Player, typename Game::Board, typename Game::Board>
+    {
+    public:
+        using Board = typename Game::Board;
+        using Word = typename Game::Word;
+        using Base = RL::StaticAgent<MNKTacticalOpponent<Game>, Player, Board, Board>;
+
+        MNKTacticalOpponent(const Player& aTrainerId, float anEpsilon) : Base(aTrainerId), myEpsilon(anEpsilon) {}
+
+        Board GetNextAction(const Board& aCurrentState)
+        {
+            const auto playerIndex = static_cast<uint32_t>(this->myId) - 1;
+            const auto playableCells = Game::GetPlayableCellsMask(aCurrentState);
+
+            assert(playableCells != 0);
+
+            auto nextState = aCurrentState;
+
+            if (this->myRandomGenerator.NextFloat() >= myEpsilon)
+            {
+                const auto& ownCells = aCurrentState.myCells[playerIndex];
+                const auto& otherCells = aCurrentState.myCells[1 - playerIndex];
+
+                Word blockingCell = 0;
+
+                for (auto cells = playableCells; cells != 0; cells &= cells - 1)
+                {
+                    const auto cell = cells & (~cells + 1);
+
+                    if (Game::HasLine(ownCells | cell))
+                    {
+                        nextState.myCells[playerIndex] |= cell;
+                        return nextState;
+                    }
+
+                    if (blockingCell == 0 && Game::HasLine(otherCells | cell))
+                    {
+                        blockingCell = cell;
+                    }
+                }
+
+                if (blockingCell != 0)
+                {
+                    nextState.myCells[playerIndex] |= blockingCell;
+                    return nextState;
+                }
+            }
+
+            nextState.myCells[playerIndex] |= SelectRandomCell(playableCells);
+
+            return nextState;
+        }
+
+    private:
+        Word SelectRandomCell(Word someCells) const
+        {
+            const auto cellsCount = static_cast<std::size_t>(Game::CountCells(someCells));
+
+            for (auto skippedCount = this->myRandomGenerator.NextIndex(cellsCount); skippedCount > 0; --skippedCount)
+            {
+                someCells &= someCells - 1;
+            }
+
+            return someCells & (~someCells + 1);
+        }
+
+        float myEpsilon;
+    };
+}
+
+#endif //RLEXPERIMENTS_MNKOPPONENTS_H
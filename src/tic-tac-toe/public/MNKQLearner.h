@@ -0,0 +1,146 @@
+//
+// Created by Gianmarco Picarella on 17/10/22.
+//
+
+#ifndef RLEXPERIMENTS_MNKQLEARNER_H
+#define RLEXPERIMENTS_MNKQLEARNER_H
+
+#include <cassert>
+#include <cstddef>
+#include <cstdint>
+#include <unordered_map>
+
+#include <StaticQLearnerPolicy.h>
+
+#include "MNKGame.h"
+#include "QLearnerJobs.h"
+#include "TicTacToeSettings.h"
+
+#include "PlayerEnum.h"
+#include "BoardStatusEnum.h"
+
+namespace TTT
+{
+    // Hashed action values of an m,n,k-game learner. Larger boards cannot be enumerated up front, so every board has
+    // an implicit value: the static score of its status until the board is first updated.
+    template <typename Game>
+    class MNKActionValueStorage
+    {
+    public:
+        using Board = typename Game::Board;
+
+        static constexpr bool IsSharedBetweenCopies = false;
+
+        void SetDefaultValues(const Player anAgentId, const RL::BaseLearningSettings<BoardStatus>& someLearningSettings)
+        {
+            myAgentId = anAgentId;
+
+            for (const auto& statusScore : someLearningSettings.myStaticScores)
+            {
+                myStaticScores[static_cast<uint32_t>(statusScore.first)] = statusScore.second;
+            }
+        }
+
+        bool Contains(const Board&) const { return true; }
+
+        float Get(const Board& aBoard) const
+        {
+            const auto valueIt = myValues.find(aBoard);
+            return valueIt != myValues.end() ? valueIt->second : GetDefaultValue(aBoard);
+        }
+
+        void Set(const Board& aBoard, float aValue)
+        {
+            myValues[aBoard] = aValue;
+        }
+
+        void Add(const Board& aBoard, float aDelta)
+        {
+            auto valueIt = myValues.find(aBoard);
+
+            // The status of the board is only evaluated on its first update
+            if (valueIt == myValues.end())
+            {
+                valueIt = myValues.emplace(aBoard, GetDefaultValue(aBoard)).first;
+            }
+
+            valueIt->second += aDelta;
+        }
+
+        // Number of boards whose value has been updated
+        std::size_t GetStoredValuesCount() const { return myValues.size(); }
+
+    private:
+        float GetDefaultValue(const Board& aBoard) const
+        {
+            return myStaticScores[static_cast<uint32_t>(Game::GetBoardStatus(myAgentId, aBoard))];
+        }
+
+        Player myAgentId { Player::Cross };
+
+        // Indexed by BoardStatus
+        float myStaticScores[4] { 0.f, 0.f, 0.f, 0.f };
+
+        std::unordered_map<Board, float> myValues;
+    };
+
+    // Q-learner of an m,n,k-game, e.g. MNKQLearner<ConnectFour>. It learns like StaticTicTacToeQLearner, which keeps
+    // the dense table of the 3x3 board, from boards hashed on the fly; symmetries and shared side tables are not supported.
+    template <typename Game>
+    class MNKQLearner final :
+            public RL::StaticQLearnerPolicy<MNKQLearner<Game>, Player, typename Game::Board, typename Game::Board,
+                                            TicTacToeSettings<BoardStatus>, BoardStatus, MNKActionValueStorage<Game>,
+                                            typename Game::MoveList>
+    {
+    public:
+        using Board = typename Game::Board;
+        using Base = RL::StaticQLearnerPolicy<MNKQLearner<Game>, Player, Board, Board, TicTacToeSettings<BoardStatus>,
+                                              BoardStatus, MNKActionValueStorage<Game>, typename Game::MoveList>;
+
+        MNKQLearner(const Player& anAgentId, const TicTacToeSettings<BoardStatus>& aLearningSettings) :
+                Base(anAgentId, aLearningSettings)
+        {
+            assert(!aLearningSettings.myUseSymmetries && !aLearningSettings.myShareSidesTable &&
+                   "Symmetries and shared side tables are only supported on the 3x3 board");
+
+            this->myActionValueScores.SetDefaultValues(anAgentId, aLearningSettings);
+        }
+
+    private:
+        // The static bases call the jobs below
+        friend Base;
+        friend typename Base::Base;
+
+        bool IsAgentLastMove(const Board& aLastMove, BoardStatus& anOutMoveStatus) const
+        {
+            anOutMoveStatus = Game::GetBoardStatus(this->myId, aLastMove);
+
+            // Odd moves belong to whoever moved first
+            const auto isLastMoveOdd = (Game::GetPiecesCount(aLastMove) & 1) == 1;
+
+            return isLastMoveOdd != this->myLearningSettings.myIsAgentDelayed;
+        }
+
+        typename Game::MoveList ComputeAgentActions(const Board& aCurrentState) const
+        {
+            return Game::GenerateMoves(this->myId, aCurrentState);
+        }
+
+        Board ExplorationJob(const Board& aCurrentState) const
+        {
+            return Utils::SelectRandomMove<Game>(this->myId, aCurrentState, this->myRandomGenerator);
+        }
+
+        Board GreedyJob(const Board& aCurrentState, float& anOutMaxValue) const
+        {
+            return Utils::SelectGreedyMove<Game>(this->myActionValueScores, this->myId, aCurrentState, this->myRandomGenerator, anOutMaxValue);
+        }
+
+        float GetMaxActionValue(const Board& aCurrentState) const
+        {
+            return Utils::GetMaxMoveValue<Game>(this->myActionValueScores, this->myId, aCurrentState);
+        }
+    };
+}
+
+#endif //RLEXPERIMENTS_MNKQLEARNER_H
@@ -0,0 +1,319 @@
+//
+// Created by Gianmarco Picarella on 13/10/22.
+//
+
+#ifndef RLEXPERIMENTS_PARALLELSIMULATION_H
+#define RLEXPERIMENTS_PARALLELSIMULATION_H
+
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <type_traits>
+#include <vector>
+
+#include "GameUtils.h"
+
+namespace TTT
+{
+namespace Utils
+{
+struct ParallelSimulationSettings
+{
+    // Number of worker threads, each one owning a copy of the learner and its own trainer
+    int myThreadsCount { 1 };
+
+    // Episodes played by every worker between two merges of the learned values, 0 merges once at the end
+    int myMergeInterval { 0 };
+
+    // Episodes claimed by a worker at once
+    int myChunkSize { 32 };
+};
+
+// Default per-worker observer factory of ParallelSimulate, no worker observes its episodes
+struct NullEpisodeObserverFactory
+{
+    NullEpisodeObserver operator()(int) const { return {}; }
+};
+
+namespace Detail
+{
+    // Work stealing scheduler over a range of episodes.
+    // Every worker starts with an even share of the range and consumes it from the front in chunks,
+    // once its share is exhausted it steals the back half of the share of another worker.
+    class EpisodeScheduler
+    {
+    public:
+        explicit EpisodeScheduler(int aWorkersCount) : myRanges(aWorkersCount) {}
+
+        void Reset(int aFirstEpisode, int anEpisodesCount)
+        {
+            const auto workersCount = static_cast<int64_t>(myRanges.size());
+
+            for (int64_t workerIndex = 0; workerIndex < workersCount; ++workerIndex)
+            {
+                const auto rangeBegin = aFirstEpisode + anEpisodesCount * workerIndex / workersCount;
+                const auto rangeEnd = aFirstEpisode + anEpisodesCount * (workerIndex + 1) / workersCount;
+
+                myRanges[workerIndex].myRange.store(Pack(rangeBegin, rangeEnd));
+            }
+        }
+
+        // Returns false once every episode of the range has been claimed
+        bool Claim(int aWorkerIndex, int aChunkSize, int& anOutBegin, int& anOutEnd)
+        {
+            do
+            {
+                auto& ownRange = myRanges[aWorkerIndex].myRange;
+                auto range = ownRange.load();
+
+                while (GetBegin(range) < GetEnd(range))
+                {
+                    const auto claimedEnd = std::min(GetBegin(range) + aChunkSize, GetEnd(range));
+
+                    if (ownRange.compare_exchange_weak(range, Pack(claimedEnd, GetEnd(range))))
+                    {
+                        anOutBegin = GetBegin(range);
+                        anOutEnd = claimedEnd;
+                        return true;
+                    }
+                }
+            }
+            while (Steal(aWorkerIndex));
+
+            return false;
+        }
+
+    private:
+        // Keeps the ranges of different workers on different cache lines
+        struct PaddedRange
+        {
+            std::atomic<uint64_t> myRange { 0 };
+            char myPadding[64 - sizeof(std::atomic<uint64_t>)];
+        };
+
+        static uint64_t Pack(int64_t aBegin, int64_t anEnd)
+        {
+            return (static_cast<uint64_t>(aBegin) << 32) | static_cast<uint32_t>(anEnd);
+        }
+
+        static int GetBegin(uint64_t aRange) { return static_cast<int>(aRange >> 32); }
+        static int GetEnd(uint64_t aRange) { return static_cast<int>(aRange & 0xFFFFFFFF); }
+
+        bool Steal(int aThiefIndex)
+        {
+            const auto workersCount = static_cast<int>(myRanges.size());
+
+            for (auto offset = 1; offset < workersCount; ++offset)
+            {
+                auto& victimRange = myRanges[(aThiefIndex + offset) % workersCount].myRange;
+                auto range = victimRange.load();
+
+                while (GetBegin(range) < GetEnd(range))
+                {
+                    const auto stolenBegin = GetBegin(range) + (GetEnd(range) - GetBegin(range)) / 2;
+
+                    if (victimRange.compare_exchange_weak(range, Pack(GetBegin(range), stolenBegin)))
+                    {
+                        // The thief range is empty, nobody else can modify it concurrently
+                        myRanges[aThiefIndex].myRange.store(Pack(stolenBegin, GetEnd(range)));
+                        return true;
+                    }
+                }
+            }
+
+            return false;
+        }
+
+        std::vector<PaddedRange> myRanges;
+    };
+}
+
+// Runs the episodes on a pool of worker threads, each one training a copy of the learner against its own trainer.
+// Workers' action values are averaged into aLearningAgent every merge interval and at the end, then copied back to the
+// workers along with the exploration rate: workers keep the rest of their state, replay buffers included.
+// Learners whose storage is shared between copies (Hogwild) skip the values merge.
+// The exploration rate merged back combines the decays applied by every worker during the round, so it decays with
+// the total number of moves played as it would on a single thread.
+// Learners and trainers of the workers draw from disjoint streams of aLearningAgent's generator.
+// Every worker thread builds its own episode observer (see Simulate) with aWorkerObserverFactory(aWorkerIndex), which
+// observes the episodes the worker plays and ends with the simulation. Observers state shared between workers must be
+// synchronized, e.g. behind a SynchronizedSummaryObserver.
+template <typename Learner, typename WorkerObserverFactory = NullEpisodeObserverFactory>
+void ParallelSimulate(Learner& aLearningAgent,
+                      const std::function<std::unique_ptr<RL::Agent<TTT::Player, uint32_t, uint32_t>>()>& aTrainerAgentFactory,
+                      int anIterationsCount,
+                      const ParallelSimulationSettings& someSettings,
+                      bool aFirstMoveFromLearnerFlag = true,
+                      const WorkerObserverFactory& aWorkerObserverFactory = WorkerObserverFactory{})
+{
+    using ActionValueStorage = std::decay_t<decltype(aLearningAgent.GetActionValueScores())>;
+
+    const auto workersCount = std::max(1, someSettings.myThreadsCount);
+    const auto chunkSize = std::max(1, someSettings.myChunkSize);
+    const auto roundSize = someSettings.myMergeInterval > 0 ? someSettings.myMergeInterval * workersCount : anIterationsCount;
+    const auto isTraining = aLearningAgent.GetLearningSettings().myIsTraining;
+    const auto isUpdatingOnline = aLearningAgent.IsUpdatingOnline();
+
+    std::vector<Learner> workerLearners(workersCount, aLearningAgent);
+    std::vector<std::unique_ptr<RL::Agent<TTT::Player, uint32_t, uint32_t>>> workerTrainers;
+
+    auto workerRandomGenerator = aLearningAgent.GetRandomGenerator();
+
+    for (auto workerIndex = 0; workerIndex < workersCount; ++workerIndex)
+    {
+        workerTrainers.push_back(aTrainerAgentFactory());
+
+        workerRandomGenerator.Jump();
+        workerLearners[workerIndex].SetRandomGenerator(workerRandomGenerator);
+
+        workerRandomGenerator.Jump();
+        workerTrainers[workerIndex]->SetRandomGenerator(workerRandomGenerator);
+    }
+
+    Detail::EpisodeScheduler episodeScheduler(workersCount);
+
+    std::mutex roundMutex;
+    std::condition_variable roundCondition;
+    auto roundIndex = 0;
+    auto finishedWorkersCount = 0;
+    auto isStopping = false;
+
+    const auto workerJob = [&](int aWorkerIndex)
+    {
+        auto& learner = workerLearners[aWorkerIndex];
+        auto& trainer = *workerTrainers[aWorkerIndex];
+        auto episodeObserver = aWorkerObserverFactory(aWorkerIndex);
+
+        std::vector<uint32_t> gameplayHistory;
+        auto lastRoundIndex = 0;
+
+        for (;;)
+        {
+            {
+                std::unique_lock<std::mutex> lock(roundMutex);
+                roundCondition.wait(lock, [&]() { return isStopping || roundIndex != lastRoundIndex; });
+
+                if (isStopping)
+                {
+                    break;
+                }
+
+                lastRoundIndex = roundIndex;
+            }
+
+            int chunkBegin, chunkEnd;
+
+            while (episodeScheduler.Claim(aWorkerIndex, chunkSize, chunkBegin, chunkEnd))
+            {
+                for (auto episodeIdx = chunkBegin; episodeIdx < chunkEnd; ++episodeIdx)
+                {
+                    PlayEpisode(learner, trainer, aFirstMoveFromLearnerFlag, gameplayHistory);
+
+                    episodeObserver.OnEpisodeEnd(gameplayHistory, episodeIdx);
+
+                    if (isUpdatingOnline)
+                    {
+                        learner.EndEpisode(gameplayHistory.back());
+                    }
+                    else if (isTraining)
+                    {
+                        learner.Update(gameplayHistory);
+                    }
+
+                    gameplayHistory.clear();
+                }
+            }
+
+            {
+                std::lock_guard<std::mutex> lock(roundMutex);
+                ++finishedWorkersCount;
+            }
+
+            roundCondition.notify_all();
+        }
+
+        episodeObserver.OnSimulationEnd();
+    };
+
+    std::vector<std::thread> workers;
+
+    for (auto workerIndex = 0; workerIndex < workersCount; ++workerIndex)
+    {
+        workers.emplace_back(workerJob, workerIndex);
+    }
+
+    for (auto firstEpisode = 0; firstEpisode < anIterationsCount; firstEpisode += roundSize)
+    {
+        const auto roundRandomEpsilon = aLearningAgent.GetLearningSettings().myRandomEpsilon;
+
+        episodeScheduler.Reset(firstEpisode, std::min(roundSize, anIterationsCount - firstEpisode));
+
+        {
+            std::lock_guard<std::mutex> lock(roundMutex);
+            finishedWorkersCount = 0;
+            ++roundIndex;
+        }
+
+        roundCondition.notify_all();
+
+        {
+            std::unique_lock<std::mutex> lock(roundMutex);
+            roundCondition.wait(lock, [&]() { return finishedWorkersCount == workersCount; });
+        }
+
+        if (isTraining)
+        {
+            // Workers of a shared table already update the caller's one, only their exploration rates are merged
+            std::vector<const ActionValueStorage*> workerActionValueScores;
+            auto randomEpsilon = static_cast<double>(roundRandomEpsilon);
+
+            for (const auto& workerLearner : workerLearners)
+            {
+                workerActionValueScores.push_back(&workerLearner.GetActionValueScores());
+
+                // Every worker started the round from roundRandomEpsilon, their decay factors multiply
+                if (roundRandomEpsilon > 0.f)
+                {
+                    randomEpsilon *= workerLearner.GetLearningSettings().myRandomEpsilon / static_cast<double>(roundRandomEpsilon);
+                }
+            }
+
+            if (!ActionValueStorage::IsSharedBetweenCopies)
+            {
+                aLearningAgent.AverageActionValueScores(workerActionValueScores);
+            }
+
+            aLearningAgent.SetRandomEpsilon(static_cast<float>(randomEpsilon));
+
+            for (auto& workerLearner : workerLearners)
+            {
+                if (!ActionValueStorage::IsSharedBetweenCopies)
+                {
+                    workerLearner.SetActionValueScores(aLearningAgent.GetActionValueScores());
+                }
+
+                workerLearner.SetRandomEpsilon(static_cast<float>(randomEpsilon));
+            }
+        }
+    }
+
+    {
+        std::lock_guard<std::mutex> lock(roundMutex);
+        isStopping = true;
+    }
+
+    roundCondition.notify_all();
+
+    for (auto& worker : workers)
+    {
+        worker.join();
+    }
+}
+}
+}
+
+#endif //RLEXPERIMENTS_PARALLELSIMULATION_H
@@ -0,0 +1,78 @@
+//
+// Created by Gianmarco Picarella on 17/10/22.
+//
+
+#ifndef RLEXPERIMENTS_POLICYCHECKPOINTER_H
+#define RLEXPERIMENTS_POLICYCHECKPOINTER_H
+
+#include <chrono>
+#include <condition_variable>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "EpisodeObservers.h"
+#include "PolicySerialization.h"
+#include "TicTacToeQLearner.h"
+
+namespace TTT
+{
+namespace Utils
+{
+    // Summary observer saving a training learner every anEpisodesInterval episodes and/or every aSecondsInterval seconds
+    // (zero disables either), checked whenever a summary is received.
+    // A checkpoint copies the settings and the dense slot values of the learner into a snapshot and hands it to a background
+    // thread, which restores a learner from it and serializes it with SavePolicyAtomically. The replay buffer is not part
+    // of a saved policy and is left out, so the training thread only pays for one table copy into a reused buffer; if the
+    // previous checkpoint is still being written, the copy is postponed to the next summary instead of waiting for it.
+    class PolicyCheckpointer
+    {
+    public:
+        PolicyCheckpointer(const TicTacToeQLearner& aLearner, const std::string& aPath, const PolicyFormat aFormat,
+                           int anEpisodesInterval, double aSecondsInterval);
+        ~PolicyCheckpointer();
+
+        PolicyCheckpointer(const PolicyCheckpointer&) = delete;
+        PolicyCheckpointer& operator=(const PolicyCheckpointer&) = delete;
+
+        void OnEpisodesSummary(const EpisodesSummary& aSummary);
+
+        // Waits for the checkpoint being written and joins the writer thread, further summaries do nothing
+        void Stop();
+
+        int GetWrittenCheckpointsCount() const;
+        int GetFailedCheckpointsCount() const;
+
+    private:
+        void WriteLoop();
+
+        const TicTacToeQLearner* myLearner;
+        std::string myPath;
+        PolicyFormat myFormat;
+
+        int myEpisodesInterval;
+        std::chrono::steady_clock::duration mySecondsInterval;
+
+        int myEpisodesSinceCheckpoint;
+        std::chrono::steady_clock::time_point myLastCheckpointTime;
+
+        // Only touched by the writer thread while pending
+        Player mySnapshotAgentId;
+        TicTacToeSettings<BoardStatus> mySnapshotSettings;
+        Utils::BoardSlotMapper mySnapshotBoardSlotMapper;
+        std::vector<float> mySnapshotSlotValues;
+
+        mutable std::mutex mySnapshotMutex;
+        std::condition_variable mySnapshotCondition;
+        bool myIsSnapshotPending;
+        bool myIsStopping;
+        int myWrittenCheckpointsCount;
+        int myFailedCheckpointsCount;
+
+        std::thread myWriterThread;
+    };
+}
+}
+
+#endif //RLEXPERIMENTS_POLICYCHECKPOINTER_H
@@ -0,0 +1,36 @@
+//
+// Created by Gianmarco Picarella on 17/10/22.
+//
+
+#ifndef RLEXPERIMENTS_POLICYEVALUATION_H
+#define RLEXPERIMENTS_POLICYEVALUATION_H
+
+#include <cstdint>
+
+#include "TicTacToeQLearner.h"
+
+#include "PlayerEnum.h"
+#include "BoardStatusEnum.h"
+
+namespace TTT
+{
+namespace Utils
+{
+struct PolicyEvaluationResult
+{
+    // Probability of each outcome of a game, from the agent point of view. Indexed by BoardStatus.
+    double myOutcomeProbabilities[4] { 0.0, 0.0, 0.0, 0.0 };
+
+    // Distinct boards reached by the policy against the opponent, the empty one included
+    uint32_t myEvaluatedStatesCount { 0 };
+};
+
+// Exact counterpart of testing a learner with Simulate: every game the greedy policy can play is walked once per board,
+// weighted by the probability of the moves. Greedy ties are broken uniformly as SelectGreedyMove does, the opponent plays
+// a uniformly random move with probability anOpponentRandomEpsilon and one of the optimal ones otherwise, as
+// EpsilonOptimalOpponent does: 1 models RandomOpponent. The agent moves first unless its settings delay it.
+PolicyEvaluationResult EvaluatePolicy(const TicTacToeQLearner& aLearner, float anOpponentRandomEpsilon);
+}
+}
+
+#endif //RLEXPERIMENTS_POLICYEVALUATION_H
@@ -0,0 +1,111 @@
+//
+// Created by Gianmarco Picarella on 16/10/22.
+//
+
+#ifndef RLEXPERIMENTS_POLICYSERIALIZATION_H
+#define RLEXPERIMENTS_POLICYSERIALIZATION_H
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+#include "TicTacToeQLearner.h"
+
+namespace TTT
+{
+    enum class PolicyFormat
+    {
+        Json,
+        Binary,
+    };
+
+    // Header of the binary policy format.
+    // The header is followed, at myValuesOffset, by the mySlotsCount dense values of the action value table
+    // addressed by slot (see BoardSlotMapper), NaN for the boards without a value.
+    // Files are written with the native byte order, myByteOrderMark tells whether the reader shares it.
+    // Version 2 only stores the canonical slots of symmetry reduced tables.
+    struct PolicyFileHeader
+    {
+        static constexpr uint32_t CurrentVersion = 2;
+        static constexpr uint32_t ByteOrderMark = 0x01020304;
+
+        char myMagic[8];
+        uint32_t myVersion;
+        uint32_t myByteOrderMark;
+        uint32_t myValuesOffset;
+        uint32_t mySlotsCount;
+
+        uint32_t myAgentId;
+        uint8_t myIsTraining;
+        uint8_t myIsAgentDelayed;
+        uint8_t myUseSymmetries;
+        uint8_t myShareSidesTable;
+
+        // Layout of the values, see BoardSlotMapper
+        uint8_t myIsSymmetryReduced;
+        uint8_t myIsColourSwapped;
+        uint8_t myReserved[2];
+
+        float myLearningRate;
+        float myGamma;
+        float myRandomEpsilon;
+        float myRandomEpsilonDecay;
+
+        // Indexed by BoardStatus
+        float myStaticScores[4];
+    };
+
+    // Read-only memory mapping of a binary policy file.
+    // Values are read in place: opening a policy costs one mmap and the header validation, pages are loaded on access.
+    class MappedPolicyFile
+    {
+    public:
+        explicit MappedPolicyFile(const std::string& aPath);
+        ~MappedPolicyFile();
+
+        MappedPolicyFile(const MappedPolicyFile&) = delete;
+        MappedPolicyFile& operator=(const MappedPolicyFile&) = delete;
+
+        // False if the file could not be mapped or is not a binary policy of the current version
+        bool IsValid() const { return myHeader != nullptr; }
+
+        const PolicyFileHeader& GetHeader() const { return *myHeader; }
+        Player GetAgentId() const { return static_cast<Player>(myHeader->myAgentId); }
+        TicTacToeSettings<BoardStatus> GetLearningSettings() const;
+
+        const Utils::BoardSlotMapper& GetBoardSlotMapper() const { return myBoardSlotMapper; }
+        const float* GetSlotValues() const { return mySlotValues; }
+
+        // NaN for boards without a value
+        float GetValue(const uint32_t aBoard) const { return mySlotValues[myBoardSlotMapper.GetSlot(aBoard)]; }
+
+    private:
+        void* myMapping;
+        std::size_t myMappingSize;
+
+        const PolicyFileHeader* myHeader;
+        const float* mySlotValues;
+        Utils::BoardSlotMapper myBoardSlotMapper;
+    };
+
+namespace Utils
+{
+    constexpr auto PolicyBinaryExtension = ".bin";
+
+    // Binary for paths ending with PolicyBinaryExtension, Json otherwise
+    PolicyFormat GetPolicyFormat(const std::string& aPath);
+
+    // False if the file could not be opened or written
+    bool SavePolicy(const TicTacToeQLearner& aLearner, const std::string& aPath, const PolicyFormat aFormat);
+
+    // Writes next to aPath and renames over it once the write succeeded, so readers and crashes never see a partially
+    // written policy. Returns false, leaving aPath untouched, if the policy could not be written or the file replaced.
+    bool SavePolicyAtomically(const TicTacToeQLearner& aLearner, const std::string& aPath, const PolicyFormat aFormat);
+
+    // Binary policies are restored from their dense values, skipping the boards enumeration of a new learner.
+    // Returns false, leaving anOutLearner untouched, if the file could not be read or is not a policy of aFormat.
+    bool LoadPolicy(const std::string& aPath, const PolicyFormat aFormat, TicTacToeQLearner& anOutLearner);
+}
+}
+
+#endif //RLEXPERIMENTS_POLICYSERIALIZATION_H
@@ -0,0 +1,101 @@
+//
+// Created by Gianmarco Picarella on 17/10/22.
+//
+
+#ifndef RLEXPERIMENTS_POLICYSERVER_H
+#define RLEXPERIMENTS_POLICYSERVER_H
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "LatencyHistogram.h"
+#include "PolicySerialization.h"
+
+struct pollfd;
+
+namespace TTT
+{
+    struct PolicyServerSettings
+    {
+        // Unix domain socket to listen on, stdin/stdout are served when empty
+        std::string mySocketPath;
+
+        // Connections above this count are refused
+        int myMaxSessions { 1024 };
+
+        // Seconds between two latency reports on stderr, 0 only reports when the server stops
+        int myReportInterval { 0 };
+    };
+
+    // Answers "board -> move" requests with the greedy move of a trained policy.
+    // Requests are lines holding the 9 cells of a board in row-major order ('x', 'o' and '.' for empty cells),
+    // the response is the index (0-8) of the cell to play, or "error" if the board is invalid, finished
+    // or not the policy's turn.
+    // Sessions are multiplexed by a single-threaded poll loop over fixed-size buffers allocated up front,
+    // so serving a request does not allocate.
+    class PolicyServer
+    {
+    public:
+        PolicyServer(const std::string& aPolicyPath, const PolicyFormat aFormat);
+        ~PolicyServer();
+
+        // False if the policy could not be loaded, nothing can be served then
+        bool IsValid() const { return mySlotValues != nullptr; }
+
+        // Serves until stdin is closed or SIGINT/SIGTERM is received, false if the socket could not be opened
+        bool Run(const PolicyServerSettings& someSettings);
+
+        // Greedy move of the policy as a cell index (0 top left, 8 bottom right), false if there is none
+        bool GetMove(const uint32_t aBoard, uint32_t& anOutCellIndex) const;
+
+        // Time spent from a request line to its queued response
+        const Utils::LatencyHistogram& GetLatencyHistogram() const { return myLatencyHistogram; }
+
+    private:
+        static constexpr std::size_t InputBufferSize = 128;
+        static constexpr std::size_t OutputBufferSize = 1024;
+
+        // "error\n", every byte of a full input buffer can end a request answered with it
+        static constexpr std::size_t MaxResponseSize = 6;
+
+        static_assert(InputBufferSize * MaxResponseSize <= OutputBufferSize, "The responses to a full input buffer must fit");
+
+        struct Session
+        {
+            int myInputDescriptor { -1 };
+            int myOutputDescriptor { -1 };
+            bool myIsClosing { false };
+
+            char myInput[InputBufferSize];
+            std::size_t myInputSize { 0 };
+
+            char myOutput[OutputBufferSize];
+            std::size_t myOutputBegin { 0 };
+            std::size_t myOutputEnd { 0 };
+        };
+
+        void ServeRequests(Session& aSession);
+        void HandleRequest(const char* aRequest, std::size_t aRequestSize, Session& aSession);
+        void FlushOutput(Session& aSession) const;
+        void ReportLatency() const;
+
+        // Either the policy file stays mapped or the policy is loaded in a learner
+        std::unique_ptr<MappedPolicyFile> myMappedPolicy;
+        std::unique_ptr<TicTacToeQLearner> myLoadedPolicy;
+
+        Player myAgentId;
+        bool myIsAgentDelayed;
+        Utils::BoardSlotMapper myBoardSlotMapper;
+        const float* mySlotValues;
+
+        std::vector<Session> mySessions;
+        std::vector<pollfd> myPollDescriptors;
+
+        Utils::LatencyHistogram myLatencyHistogram;
+    };
+}
+
+#endif //RLEXPERIMENTS_POLICYSERVER_H
@@ -0,0 +1,63 @@
+//
+// Created by Gianmarco Picarella on 17/10/22.
+//
+
+#ifndef RLEXPERIMENTS_PROGRESSREPORTER_H
+#define RLEXPERIMENTS_PROGRESSREPORTER_H
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <functional>
+#include <mutex>
+#include <thread>
+
+#include "EpisodeObservers.h"
+
+namespace TTT
+{
+namespace Utils
+{
+    // Reports the number of completed episodes from its own thread, every report interval and once more when stopped.
+    // Simulations only bump an atomic counter, either as a summary observer or through AddCompletedEpisodes,
+    // so rendering the progress never slows the training loop down.
+    class ProgressReporter
+    {
+    public:
+        using ReportCallback = std::function<void(int aCompletedEpisodesCount)>;
+
+        explicit ProgressReporter(ReportCallback aReportCallback,
+                                  std::chrono::milliseconds aReportInterval = std::chrono::milliseconds(100));
+        ~ProgressReporter();
+
+        ProgressReporter(const ProgressReporter&) = delete;
+        ProgressReporter& operator=(const ProgressReporter&) = delete;
+
+        void OnEpisodesSummary(const EpisodesSummary& aSummary) { AddCompletedEpisodes(aSummary.myEpisodesCount); }
+
+        // Can be called concurrently
+        void AddCompletedEpisodes(int anEpisodesCount) { myCompletedEpisodesCount.fetch_add(anEpisodesCount, std::memory_order_relaxed); }
+
+        int GetCompletedEpisodesCount() const { return myCompletedEpisodesCount.load(std::memory_order_relaxed); }
+
+        // Joins the reporter thread after a last report, further calls do nothing
+        void Stop();
+
+    private:
+        void ReportLoop();
+
+        ReportCallback myReportCallback;
+        std::chrono::milliseconds myReportInterval;
+
+        std::atomic<int> myCompletedEpisodesCount;
+
+        std::mutex myStopMutex;
+        std::condition_variable myStopCondition;
+        bool myIsStopping;
+
+        std::thread myReporterThread;
+    };
+}
+}
+
+#endif //RLEXPERIMENTS_PROGRESSREPORTER_H
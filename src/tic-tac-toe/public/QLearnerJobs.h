@@ -0,0 +1,136 @@
+//
+// Created by Gianmarco Picarella on 17/10/22.
+//
+
+#ifndef RLEXPERIMENTS_QLEARNERJOBS_H
+#define RLEXPERIMENTS_QLEARNERJOBS_H
+
+#include <algorithm>
+#include <cassert>
+#include <cmath>
+#include <cstdint>
+#include <limits>
+
+#include <RandomGenerator.h>
+
+#include "GameUtils.h"
+#include "StateGraph.h"
+#include "TicTacToeSettings.h"
+
+namespace TTT
+{
+namespace Utils
+{
+    // Tic-tac-toe parts of the Q-learners, shared by the virtual (TicTacToeQLearner) and static (StaticTicTacToeQLearner) ones.
+    // The move selection is generic over the game (TicTacToeGame or an MNKGame), MNKQLearner and the random opponents use it too.
+
+    // Statuses missing from the settings score 0, as they did when looked up with operator[]
+    inline float GetStaticScore(const TicTacToeSettings<BoardStatus>& someLearningSettings, const BoardStatus aStatus)
+    {
+        const auto staticScore = someLearningSettings.myStaticScores.find(aStatus);
+        return staticScore != someLearningSettings.myStaticScores.end() ? staticScore->second : 0.f;
+    }
+
+    // Sets every board the agent can reach to the static score of its status
+    template <typename ActionValueStorage>
+    void InitializeActionValues(const Player anAgentId, const TicTacToeSettings<BoardStatus>& someLearningSettings,
+                                ActionValueStorage& anOutActionValueScores)
+    {
+        anOutActionValueScores.SetBoardMapping(someLearningSettings.myUseSymmetries,
+                                               someLearningSettings.myShareSidesTable && anAgentId == Player::Nought);
+
+        const auto& stateGraph = StateGraph::GetInstance();
+
+        const auto otherPlayer = static_cast<Player>((~static_cast<uint32_t>(anAgentId)) & 0x3);
+        const auto startingPlayer = someLearningSettings.myIsAgentDelayed ? otherPlayer : anAgentId;
+
+        for (const auto stateIndex : stateGraph.GetMoveResults(anAgentId, startingPlayer))
+        {
+            anOutActionValueScores.Set(stateGraph.GetBoard(stateIndex), GetStaticScore(someLearningSettings, stateGraph.GetStatus(stateIndex, anAgentId)));
+        }
+    }
+
+    inline bool IsAgentLastMove(const Player anAgentId, const bool anIsAgentDelayed, const uint32_t aLastMove, BoardStatus& anOutMoveStatus)
+    {
+        anOutMoveStatus = GetBoardStatus(anAgentId, aLastMove);
+
+        // A draw fills the board, so its last move belongs to whoever moved first
+        return anOutMoveStatus == BoardStatus::Win ||
+               (anOutMoveStatus == BoardStatus::Draw && !anIsAgentDelayed);
+    }
+
+    template <typename Game = TicTacToeGame>
+    typename Game::Board SelectRandomMove(const Player anAgentId, const typename Game::Board& aCurrentState, RL::RandomGenerator& aRandomGenerator)
+    {
+        const auto nextAgentMoves = Game::GenerateMoves(anAgentId, aCurrentState);
+
+        assert(nextAgentMoves.size() > 0);
+
+        return nextAgentMoves[aRandomGenerator.NextIndex(nextAgentMoves.size())];
+    }
+
+    // Moves within a small tolerance of the highest value, among which greedy moves are drawn uniformly
+    template <typename Game = TicTacToeGame, typename ActionValueStorage>
+    typename Game::MoveList GetGreedyMoves(const ActionValueStorage& someActionValueScores, const Player anAgentId,
+                                           const typename Game::Board& aCurrentState, float& anOutMaxValue)
+    {
+        const auto nextAgentMoves = Game::GenerateMoves(anAgentId, aCurrentState);
+
+        assert(nextAgentMoves.size() > 0);
+
+        // Read every value once, the table may be updated concurrently by other learners
+        float nextMovesValues[Game::CellsCount];
+        auto maxValue = std::numeric_limits<float>::lowest();
+
+        for (auto moveIndex = 0u; moveIndex < nextAgentMoves.size(); ++moveIndex)
+        {
+            nextMovesValues[moveIndex] = someActionValueScores.Get(nextAgentMoves[moveIndex]);
+            maxValue = std::max(maxValue, nextMovesValues[moveIndex]);
+        }
+
+        typename Game::MoveList maxMoves;
+
+        constexpr auto floatEpsilon = 0.0001f;
+
+        for (auto moveIndex = 0u; moveIndex < nextAgentMoves.size(); ++moveIndex)
+        {
+            if (std::fabs(maxValue - nextMovesValues[moveIndex]) < floatEpsilon)
+            {
+                maxMoves.push_back(nextAgentMoves[moveIndex]);
+            }
+        }
+
+        assert(maxMoves.size() > 0);
+
+        anOutMaxValue = maxValue;
+
+        return maxMoves;
+    }
+
+    // One of the moves with the highest value, ties are broken at random
+    template <typename Game = TicTacToeGame, typename ActionValueStorage>
+    typename Game::Board SelectGreedyMove(const ActionValueStorage& someActionValueScores, const Player anAgentId,
+                                          const typename Game::Board& aCurrentState, RL::RandomGenerator& aRandomGenerator, float& anOutMaxValue)
+    {
+        const auto maxMoves = GetGreedyMoves<Game>(someActionValueScores, anAgentId, aCurrentState, anOutMaxValue);
+
+        // Select one of the random max
+        return maxMoves[aRandomGenerator.NextIndex(maxMoves.size())];
+    }
+
+    template <typename Game = TicTacToeGame, typename ActionValueStorage>
+    float GetMaxMoveValue(const ActionValueStorage& someActionValueScores, const Player anAgentId, const typename Game::Board& aCurrentState)
+    {
+        auto maxValue = std::numeric_limits<float>::lowest();
+
+        for (const auto& nextAgentMove : Game::GenerateMoves(anAgentId, aCurrentState))
+        {
+            maxValue = std::max(maxValue, someActionValueScores.Get(nextAgentMove));
+        }
+
+        return maxValue;
+    }
+}
+}
+
+#endif //RLEXPERIMENTS_QLEARNERJOBS_H
@@ -10,17 +10,21 @@
 
 #include "PlayerEnum.h"
 #include "BoardStatusEnum.h"
+#include "QLearnerJobs.h"
 
 namespace TTT
 {
-    class RandomOpponent : public RL::Agent<Player, uint32_t, uint32_t>
+    class RandomOpponent final : public RL::Agent<Player, uint32_t, uint32_t>
     {
     public:
         using Base = RL::Agent<Player, uint32_t, uint32_t>;
 
         RandomOpponent(const Player& aTrainerId) : Base(aTrainerId) {}
 
-        uint32_t GetNextAction(const uint32_t& aCurrentState);
+        uint32_t GetNextAction(const uint32_t& aCurrentState)
+        {
+            return Utils::SelectRandomMove(myId, aCurrentState, myRandomGenerator);
+        }
     };
 }
 
@@ -0,0 +1,91 @@
+//
+// Created by Gianmarco Picarella on 17/10/22.
+//
+
+#ifndef RLEXPERIMENTS_RESULTSSTREAM_H
+#define RLEXPERIMENTS_RESULTSSTREAM_H
+
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <functional>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "EpisodeObservers.h"
+#include "BoardStatusEnum.h"
+
+namespace TTT
+{
+namespace Utils
+{
+    // Running totals of a training run after some episodes, from the learner point of view
+    struct ResultsStreamRecord
+    {
+        uint64_t myEpisodesCount { 0 };
+        double myCumulativeReward { 0.0 };
+
+        // Indexed by BoardStatus, the intermediate slot is unused
+        uint64_t myResultsCounts[4] { 0, 0, 0, 0 };
+    };
+
+    // Summary observer appending one record of running totals per summary to a binary file: a header followed by
+    // fixed size records, so memory does not grow with the number of episodes.
+    // Records are gathered in a chunk while a background thread writes the previous one; the training loop only
+    // waits if the disk falls a whole chunk behind.
+    class ResultsStreamWriter
+    {
+    public:
+        // someRewards are indexed by BoardStatus
+        ResultsStreamWriter(const std::string& aPath, const float (&someRewards)[4], std::size_t aChunkRecordsCount = 4096);
+        ~ResultsStreamWriter();
+
+        ResultsStreamWriter(const ResultsStreamWriter&) = delete;
+        ResultsStreamWriter& operator=(const ResultsStreamWriter&) = delete;
+
+        bool IsOpen() const { return myFile != nullptr; }
+
+        void OnEpisodesSummary(const EpisodesSummary& aSummary);
+
+        const ResultsStreamRecord& GetTotals() const { return myTotals; }
+
+        // Writes the pending records and closes the file, further summaries are dropped.
+        // Returns false if any write failed.
+        bool Close();
+
+    private:
+        void WriteLoop();
+
+        std::FILE* myFile;
+
+        float myRewards[4];
+        ResultsStreamRecord myTotals;
+
+        // Filled by the training thread
+        std::vector<ResultsStreamRecord> myFrontChunk;
+
+        // Written by the writer thread, swapped with the front one when that is full
+        std::vector<ResultsStreamRecord> myBackChunk;
+
+        std::mutex myChunkMutex;
+        std::condition_variable myChunkCondition;
+        bool myIsBackChunkPending;
+        bool myIsClosing;
+        bool myHasWriteFailed;
+
+        std::thread myWriterThread;
+    };
+
+    // Calls aRecordCallback on every record of the stream in order, reading a chunk at a time.
+    // Returns false if the file cannot be read or is not a results stream.
+    bool ReadResultsStream(const std::string& aPath, const std::function<void(const ResultsStreamRecord&)>& aRecordCallback);
+
+    // At most aMaxRecordsCount records evenly picked along the stream, the last one always included, e.g. for plotting
+    bool LoadResultsStreamPoints(const std::string& aPath, std::size_t aMaxRecordsCount, std::vector<ResultsStreamRecord>& anOutRecords);
+}
+}
+
+#endif //RLEXPERIMENTS_RESULTSSTREAM_H
@@ -0,0 +1,46 @@
+//
+// Created by Gianmarco Picarella on 12/10/22.
+//
+
+#ifndef RLEXPERIMENTS_SOLVEDGAMETABLE_H
+#define RLEXPERIMENTS_SOLVEDGAMETABLE_H
+
+#include <cstdint>
+#include <vector>
+
+#include "PlayerEnum.h"
+#include "GameUtils.h"
+
+namespace TTT
+{
+    // Minimax solution of every board reachable from the empty one, for both players to move.
+    // The table is built once per process on first access, by a backward sweep of the StateGraph, and is read-only afterwards.
+    class SolvedGameTable
+    {
+    public:
+        static const SolvedGameTable& GetInstance();
+
+        // Game value for the player to move: 1 win, 0 draw, -1 lose
+        int GetValue(const uint32_t aBoard, const Player aPlayerToMove) const;
+
+        // All the moves reaching the game value, in the same order as GenerateMoves
+        Utils::MoveList GetOptimalMoves(const uint32_t aBoard, const Player aPlayerToMove) const;
+
+    private:
+        struct Entry
+        {
+            int8_t myValue;
+            uint16_t myOptimalCellsMask;
+        };
+
+        SolvedGameTable();
+
+        // Solves a state of the StateGraph from its already solved successors
+        void Solve(const uint32_t aStateIndex, const Player aPlayerToMove);
+        const Entry& GetEntry(const uint32_t aBoard, const Player aPlayerToMove) const;
+
+        std::vector<Entry> myEntries;
+    };
+}
+
+#endif //RLEXPERIMENTS_SOLVEDGAMETABLE_H
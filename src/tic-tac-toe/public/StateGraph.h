@@ -0,0 +1,110 @@
+//
+// Created by Gianmarco Picarella on 17/10/22.
+//
+
+#ifndef RLEXPERIMENTS_STATEGRAPH_H
+#define RLEXPERIMENTS_STATEGRAPH_H
+
+#include <cstdint>
+#include <limits>
+#include <vector>
+
+#include "BoardIndexer.h"
+#include "PlayerEnum.h"
+#include "BoardStatusEnum.h"
+
+namespace TTT
+{
+    // Every board reachable from the empty one, with either player moving first, built once per process on first access.
+    // States get dense indices ordered by number of pieces, the empty board being 0, so successors always have larger
+    // indices than their predecessors. Moves are stored in compressed sparse rows, one set of rows per player to move.
+    class StateGraph
+    {
+    public:
+        static constexpr uint32_t InvalidStateIndex = std::numeric_limits<uint32_t>::max();
+
+        struct StateRange
+        {
+            const uint32_t* myBegin;
+            const uint32_t* myEnd;
+
+            const uint32_t* begin() const { return myBegin; }
+            const uint32_t* end() const { return myEnd; }
+            uint32_t size() const { return static_cast<uint32_t>(myEnd - myBegin); }
+            bool empty() const { return myBegin == myEnd; }
+        };
+
+        static const StateGraph& GetInstance();
+
+        uint32_t GetStatesCount() const { return static_cast<uint32_t>(myBoards.size()); }
+
+        uint32_t GetBoard(const uint32_t aStateIndex) const { return myBoards[aStateIndex]; }
+
+        // InvalidStateIndex for boards not reachable from the empty board
+        uint32_t GetStateIndex(const uint32_t aBoard) const { return myStateIndices[Utils::GetBoardRank(aBoard)]; }
+
+        BoardStatus GetStatus(const uint32_t aStateIndex, const Player aMovingPlayer) const
+        {
+            const auto crossStatus = static_cast<BoardStatus>(myCrossStatuses[aStateIndex]);
+
+            if (aMovingPlayer == Player::Cross || crossStatus == BoardStatus::Intermediate || crossStatus == BoardStatus::Draw)
+            {
+                return crossStatus;
+            }
+
+            return crossStatus == BoardStatus::Win ? BoardStatus::Lose : BoardStatus::Win;
+        }
+
+        bool IsTerminal(const uint32_t aStateIndex) const
+        {
+            return static_cast<BoardStatus>(myCrossStatuses[aStateIndex]) != BoardStatus::Intermediate;
+        }
+
+        // Whether a game can reach the state with aPlayerToMove to move, finished games included
+        bool IsReachable(const uint32_t aStateIndex, const Player aPlayerToMove) const
+        {
+            return (myPlayersToMoveMasks[aStateIndex] & static_cast<uint8_t>(aPlayerToMove)) != 0;
+        }
+
+        // States reached by the moves of aPlayerToMove, in the GenerateMoves order. Empty for finished
+        // states and for states that no game reaches with aPlayerToMove to move.
+        StateRange GetSuccessors(const uint32_t aStateIndex, const Player aPlayerToMove) const
+        {
+            const auto& rows = myMoveRows[static_cast<uint32_t>(aPlayerToMove) - 1];
+
+            return StateRange { rows.mySuccessors.data() + rows.myOffsets[aStateIndex],
+                                rows.mySuccessors.data() + rows.myOffsets[aStateIndex + 1] };
+        }
+
+        // States right after a move of aMovingPlayer in the games started by aStartingPlayer, by increasing index
+        const std::vector<uint32_t>& GetMoveResults(const Player aMovingPlayer, const Player aStartingPlayer) const
+        {
+            return myMoveResults[static_cast<uint32_t>(aMovingPlayer) - 1][static_cast<uint32_t>(aStartingPlayer) - 1];
+        }
+
+    private:
+        struct MoveRows
+        {
+            // mySuccessors[myOffsets[i], myOffsets[i + 1]) are the successors of state i
+            std::vector<uint32_t> myOffsets;
+            std::vector<uint32_t> mySuccessors;
+        };
+
+        StateGraph();
+
+        std::vector<uint32_t> myBoards;
+        std::vector<uint32_t> myStateIndices;
+        std::vector<uint8_t> myCrossStatuses;
+
+        // Bit Player set when the player can be the one to move
+        std::vector<uint8_t> myPlayersToMoveMasks;
+
+        // Indexed by player to move - 1
+        MoveRows myMoveRows[2];
+
+        // Indexed by moving player - 1 and starting player - 1
+        std::vector<uint32_t> myMoveResults[2][2];
+    };
+}
+
+#endif //RLEXPERIMENTS_STATEGRAPH_H
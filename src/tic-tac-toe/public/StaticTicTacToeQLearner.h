@@ -0,0 +1,77 @@
+//
+// Created by Gianmarco Picarella on 17/10/22.
+//
+
+#ifndef RLEXPERIMENTS_STATICTICTACTOEQLEARNER_H
+#define RLEXPERIMENTS_STATICTICTACTOEQLEARNER_H
+
+#include <StaticQLearnerPolicy.h>
+
+#include "BoardIndexedStorage.h"
+#include "QLearnerJobs.h"
+#include "TicTacToeQLearner.h"
+#include "TicTacToeSettings.h"
+
+#include "PlayerEnum.h"
+#include "BoardStatusEnum.h"
+
+namespace TTT
+{
+// Q-learner without virtual calls: passed by its concrete type to Simulate, together with a final opponent,
+// the whole episode loop is inlined. It learns exactly as a TicTacToeQLearner with the same settings and generator,
+// and converts to one for serialization and serving.
+class StaticTicTacToeQLearner final :
+        public RL::StaticQLearnerPolicy<StaticTicTacToeQLearner, Player, uint32_t, uint32_t, TicTacToeSettings<BoardStatus>,
+                                        BoardStatus, BoardIndexedStorage, Utils::MoveList>
+{
+public:
+    using Base = RL::StaticQLearnerPolicy<StaticTicTacToeQLearner, Player, uint32_t, uint32_t, TicTacToeSettings<BoardStatus>,
+                                          BoardStatus, BoardIndexedStorage, Utils::MoveList>;
+
+    StaticTicTacToeQLearner(const Player& anAgentId, const TicTacToeSettings<BoardStatus>& aLearningSettings) :
+            Base(anAgentId, aLearningSettings)
+    {
+        Utils::InitializeActionValues(myId, myLearningSettings, myActionValueScores);
+    }
+
+    TicTacToeQLearner ToQLearner() const
+    {
+        TicTacToeQLearner qLearner { myId, myLearningSettings, myActionValueScores.GetBoardSlotMapper(), myActionValueScores.GetSlotValues() };
+        qLearner.SetRandomGenerator(myRandomGenerator);
+
+        return qLearner;
+    }
+
+private:
+    // The static bases call the jobs below
+    friend Base;
+    friend Base::Base;
+
+    bool IsAgentLastMove(const uint32_t& aLastMove, BoardStatus& anOutMoveStatus) const
+    {
+        return Utils::IsAgentLastMove(myId, myLearningSettings.myIsAgentDelayed, aLastMove, anOutMoveStatus);
+    }
+
+    Utils::MoveList ComputeAgentActions(const uint32_t& aCurrentState) const
+    {
+        return Utils::GenerateMoves(myId, aCurrentState);
+    }
+
+    uint32_t ExplorationJob(const uint32_t& aCurrentState) const
+    {
+        return Utils::SelectRandomMove(myId, aCurrentState, myRandomGenerator);
+    }
+
+    uint32_t GreedyJob(const uint32_t& aCurrentState, float& anOutMaxValue) const
+    {
+        return Utils::SelectGreedyMove(myActionValueScores, myId, aCurrentState, myRandomGenerator, anOutMaxValue);
+    }
+
+    float GetMaxActionValue(const uint32_t& aCurrentState) const
+    {
+        return Utils::GetMaxMoveValue(myActionValueScores, myId, aCurrentState);
+    }
+};
+}
+
+#endif //RLEXPERIMENTS_STATICTICTACTOEQLEARNER_H
@@ -7,6 +7,9 @@
 
 #include <QLearningPolicy.h>
 #include "TicTacToeSettings.h"
+#include "BoardIndexedStorage.h"
+#include "AtomicBoardIndexedStorage.h"
+#include "GameUtils.h"
 
 #include "PlayerEnum.h"
 #include "BoardStatusEnum.h"
@@ -18,20 +21,57 @@ namespace TTT
         constexpr auto defaultAgentId = Player::Cross;
     }
 
-class TicTacToeQLearner : public RL::QLearnerPolicy<Player, uint32_t, uint32_t, TicTacToeSettings<BoardStatus>, BoardStatus>
+template <typename ActionValueStorage>
+class BasicTicTacToeQLearner : public RL::QLearnerPolicy<Player, uint32_t, uint32_t, TicTacToeSettings<BoardStatus>, BoardStatus, ActionValueStorage, Utils::MoveList>
 {
 public:
-    using Base = RL::QLearnerPolicy<Player, uint32_t, uint32_t, TicTacToeSettings<BoardStatus>, BoardStatus>;
+    using Base = RL::QLearnerPolicy<Player, uint32_t, uint32_t, TicTacToeSettings<BoardStatus>, BoardStatus, ActionValueStorage, Utils::MoveList>;
 
-    TicTacToeQLearner() : Base(defaultAgentId, TicTacToeSettings<BoardStatus>{}) {}
-    TicTacToeQLearner(const Player& anAgentId, const TicTacToeSettings<BoardStatus>& aLearningSettings);
+    BasicTicTacToeQLearner() : Base(defaultAgentId, TicTacToeSettings<BoardStatus>{}) {}
+    BasicTicTacToeQLearner(const Player& anAgentId, const TicTacToeSettings<BoardStatus>& aLearningSettings);
+
+    // Restores a learner from the dense slot values of a saved table, without enumerating the boards again
+    BasicTicTacToeQLearner(const Player& anAgentId, const TicTacToeSettings<BoardStatus>& aLearningSettings,
+                           const Utils::BoardSlotMapper& aBoardSlotMapper, const float* someSlotValues);
+
+    // Copies agent, settings, random generator and action values of a learner backed by a different storage
+    template <typename OtherActionValueStorage>
+    explicit BasicTicTacToeQLearner(const BasicTicTacToeQLearner<OtherActionValueStorage>& anOtherLearner) :
+            Base(anOtherLearner.GetAgentId(), anOtherLearner.GetLearningSettings())
+    {
+        this->SetRandomGenerator(anOtherLearner.GetRandomGenerator());
+
+        const auto& otherActionValueScores = anOtherLearner.GetActionValueScores();
+        const auto& boardSlotMapper = otherActionValueScores.GetBoardSlotMapper();
+
+        this->myActionValueScores.SetBoardMapping(boardSlotMapper.IsSymmetryReduced(), boardSlotMapper.IsColourSwapped());
+
+        for (uint32_t slot = 0; slot < boardSlotMapper.GetSlotsCount(); ++slot)
+        {
+            const auto board = boardSlotMapper.GetBoard(slot);
+
+            if (otherActionValueScores.Contains(board))
+            {
+                this->myActionValueScores.Set(board, otherActionValueScores.Get(board));
+            }
+        }
+    }
 
 protected:
     bool IsAgentLastMove(const uint32_t& aLastMove, BoardStatus& anOutMoveStatus) const;
-    std::vector<uint32_t> ComputeAgentActions(const uint32_t& aCurrentState) const;
+    Utils::MoveList ComputeAgentActions(const uint32_t& aCurrentState) const;
     uint32_t ExplorationJob(const uint32_t& aCurrentState) const;
-    uint32_t GreedyJob(const uint32_t& aCurrentState) const;
+    uint32_t GreedyJob(const uint32_t& aCurrentState, float& anOutMaxValue) const;
+    float GetMaxActionValue(const uint32_t& aCurrentState) const;
 };
+
+using TicTacToeQLearner = BasicTicTacToeQLearner<BoardIndexedStorage>;
+
+// Copies of a Hogwild learner share one lock-free table, see AtomicBoardIndexedStorage
+using HogwildTicTacToeQLearner = BasicTicTacToeQLearner<AtomicBoardIndexedStorage>;
+
+extern template class BasicTicTacToeQLearner<BoardIndexedStorage>;
+extern template class BasicTicTacToeQLearner<AtomicBoardIndexedStorage>;
 }
 
 #endif //RLEXPERIMENTS_TICTACTOEQLEARNER_H
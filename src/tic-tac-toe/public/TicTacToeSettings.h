@@ -6,6 +6,7 @@
 #define RLEXPERIMENTS_TICTACTOESETTINGS_H
 
 #include <LearningSettings/QLearningSettings.h>
+#include <SerializationUtils.h>
 
 namespace TTT
 {
@@ -14,10 +15,20 @@ struct TicTacToeSettings : public RL::QLearningSettings<ActionStatus>
     {
         bool myIsAgentDelayed { false };
 
+        // Share one action value between the eight rotations/reflections of a board
+        bool myUseSymmetries { false };
+
+        // Store boards as if the agent played cross, so that cross and nought tables are interchangeable
+        bool myShareSidesTable { false };
+
         template<class Archive>
         void serialize(Archive & archive)
         {
             archive(cereal::base_class<RL::QLearningSettings<ActionStatus>>(this), CEREAL_NVP(myIsAgentDelayed));
+
+            // Absent from the policies saved before the symmetries
+            RL::SerializeOptionalNVP(archive, "myUseSymmetries", myUseSymmetries);
+            RL::SerializeOptionalNVP(archive, "myShareSidesTable", myShareSidesTable);
         }
     };
 }
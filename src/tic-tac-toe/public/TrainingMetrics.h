@@ -0,0 +1,129 @@
+//
+// Created by Gianmarco Picarella on 17/10/22.
+//
+
+#ifndef RLEXPERIMENTS_TRAININGMETRICS_H
+#define RLEXPERIMENTS_TRAININGMETRICS_H
+
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <mutex>
+#include <string>
+#include <vector>
+
+#include <LearnerStatistics.h>
+
+#include "BoardStatusEnum.h"
+
+namespace TTT
+{
+    enum class MetricsFormat
+    {
+        JsonLines,
+        Prometheus,
+    };
+
+    struct TrainingMetricsSnapshot
+    {
+        uint64_t myEpisodesCount { 0 };
+        uint64_t myMovesCount { 0 };
+        double myElapsedSeconds { 0.0 };
+
+        // Throughput since the previous snapshot
+        double myEpisodesPerSecond { 0.0 };
+        double myMovesPerSecond { 0.0 };
+
+        // Share of exploration moves among the learner moves since the previous snapshot
+        double myExplorationRatio { 0.0 };
+        float myRandomEpsilon { 0.f };
+
+        // Mean absolute change of the updated action values since the previous snapshot
+        double myMeanValueUpdateMagnitude { 0.0 };
+
+        // Episodes' results over the sliding window, from the learner point of view
+        double myWinRate { 0.0 };
+        double myDrawRate { 0.0 };
+        double myLoseRate { 0.0 };
+    };
+
+    // Training speed and learning progress of a learner.
+    // Recording an episode updates a few counters and the results sliding window, snapshots of the derived rates
+    // are taken every interval (checked once every few episodes) and optionally dumped to a file:
+    // JSON lines are appended, Prometheus text files are replaced atomically.
+    class TrainingMetrics
+    {
+    public:
+        explicit TrainingMetrics(std::size_t aWindowSize = 1000, double aSnapshotInterval = 1.0);
+
+        // False if the file cannot be written, snapshots are not dumped then
+        bool SetDumpFile(const std::string& aPath, const MetricsFormat aFormat);
+
+        void RecordEpisode(std::size_t aMovesCount, const BoardStatus anAgentStatus,
+                           const RL::LearnerStatistics& someLearnerStatistics, float aRandomEpsilon)
+        {
+            ++myEpisodesCount;
+            myMovesCount += aMovesCount;
+
+            auto& windowSlot = myResultsWindow[myResultsWindowIndex];
+
+            if (myEpisodesCount > myResultsWindow.size())
+            {
+                --myResultsCounts[static_cast<uint32_t>(windowSlot)];
+            }
+
+            windowSlot = anAgentStatus;
+            ++myResultsCounts[static_cast<uint32_t>(anAgentStatus)];
+
+            myResultsWindowIndex = myResultsWindowIndex + 1 == myResultsWindow.size() ? 0 : myResultsWindowIndex + 1;
+
+            // Reading the clock costs a fraction of an episode, it is only checked every few of them
+            if ((myEpisodesCount & (ClockCheckPeriod - 1)) == 0 && std::chrono::steady_clock::now() >= myNextSnapshotTime)
+            {
+                TakeSnapshot(someLearnerStatistics, aRandomEpsilon);
+            }
+        }
+
+        // Computes, stores and dumps a snapshot right away, e.g. at the end of the training
+        void TakeSnapshot(const RL::LearnerStatistics& someLearnerStatistics, float aRandomEpsilon);
+
+        // Last snapshot taken, can be read from other threads
+        TrainingMetricsSnapshot GetSnapshot() const;
+
+        // Snapshots that could not be written to the dump file
+        uint64_t GetFailedDumpsCount() const { return myFailedDumpsCount; }
+
+    private:
+        static constexpr uint64_t ClockCheckPeriod = 256;
+
+        bool DumpSnapshot(const TrainingMetricsSnapshot& aSnapshot) const;
+
+        uint64_t myEpisodesCount;
+        uint64_t myMovesCount;
+
+        std::vector<BoardStatus> myResultsWindow;
+        std::size_t myResultsWindowIndex;
+
+        // Indexed by BoardStatus
+        uint64_t myResultsCounts[4];
+
+        std::chrono::steady_clock::time_point myStartTime;
+        std::chrono::steady_clock::duration mySnapshotInterval;
+        std::chrono::steady_clock::time_point myNextSnapshotTime;
+
+        // Counters at the previous snapshot
+        std::chrono::steady_clock::time_point myLastSnapshotTime;
+        uint64_t myLastEpisodesCount;
+        uint64_t myLastMovesCount;
+        RL::LearnerStatistics myLastLearnerStatistics;
+
+        std::string myDumpPath;
+        MetricsFormat myDumpFormat;
+        uint64_t myFailedDumpsCount;
+
+        mutable std::mutex mySnapshotMutex;
+        TrainingMetricsSnapshot mySnapshot;
+    };
+}
+
+#endif //RLEXPERIMENTS_TRAININGMETRICS_H
@@ -0,0 +1,45 @@
+//
+// Created by Gianmarco Picarella on 17/10/22.
+//
+
+#ifndef RLEXPERIMENTS_VALUEITERATION_H
+#define RLEXPERIMENTS_VALUEITERATION_H
+
+#include "TicTacToeQLearner.h"
+#include "TicTacToeSettings.h"
+
+#include "PlayerEnum.h"
+#include "BoardStatusEnum.h"
+
+namespace TTT
+{
+namespace Utils
+{
+struct ValueIterationSettings
+{
+    // Probability of a uniformly random opponent move, the other moves are drawn among the optimal ones
+    // as EpsilonOptimalOpponent does: 1 models RandomOpponent
+    float myOpponentRandomEpsilon { 1.f };
+
+    // Sweeps stop once no value changes by more than the tolerance
+    float myTolerance { 0.000001f };
+    int myMaxSweepsCount { 100 };
+};
+
+struct ValueIterationResult
+{
+    int mySweepsCount { 0 };
+    float myMaxValueChange { 0.f };
+};
+
+// Model-based counterpart of Q-learning: the opponent's move probabilities are known exactly, so the values the
+// learner's Update converges to are computed by value iteration over every board the agent can move to.
+// Boards are walked on the StateGraph from the fullest to the emptiest, which solves the game tree in a single sweep;
+// a second one confirms convergence. The result is a learner with the same settings and table layout as a trained one.
+TicTacToeQLearner SolveActionValues(const Player anAgentId, const TicTacToeSettings<BoardStatus>& someLearningSettings,
+                                    const ValueIterationSettings& someValueIterationSettings,
+                                    ValueIterationResult* anOutResult = nullptr);
+}
+}
+
+#endif //RLEXPERIMENTS_VALUEITERATION_H